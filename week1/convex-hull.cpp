@@ -1,98 +1,659 @@
-#include <bits/stdc++.h>
-#include "list.h"
-
-using i64 = long long;
-
-constexpr double eps = 1e-8;
-inline int dcmp(double a) {
-  if (fabs(a) < eps) return 0;
-  return a < 0 ? -1 : 1;
-}
-
-struct Point {
-  double x, y;
-  Point() {}
-  Point(double a, double b) : x(a), y(b) {}
-};
-
-typedef Point Vector;
-Vector operator +(Vector A, Vector B) {
-  return Vector(A.x + B.x, A.y + B.y);
-}
-
-Vector operator -(Vector A, Vector B) {
-  return Vector(A.x - B.x, A.y - B.y);
-}
-
-Vector operator *(Vector A, double p) {
-  return Vector(A.x * p, A.y * p);
-}
-
-Vector operator /(Vector A, double p) {
-  return Vector(A.x / p, A.y / p);
-}
-
-inline double dot(Vector A, Vector B) {
-  return A.x * B.x + A.y * B.y;
-}
-
-inline double cross(Vector A, Vector B) {
-  return A.x * B.y - A.y * B.x;
-}
-
-inline double length(Vector A) {
-  return sqrt(dot(A, A));
-}
-
-inline double angle(Vector A, Vector B) {
-  return acos(dot(A, B) / length(A) / length(B));
-}
-
-inline double dist(Point a, Point b) {
-  return sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
-}
-
-inline Vector rotate(Point a, double t) {
-  return Vector(a.x * cos(t) - a.y * sin(t), a.x * sin(t) + a.y * cos(t));
-}
-
-std::vector<Point> Graham(std::vector<Point> points){
-  int N = points.size();
-  if (N <= 1) return points;
-
-  int pivot = 0;
-  for(int i = 1; i < N; ++i) {
-    if (dcmp(points[i].y - points[pivot].y) < 0 || (dcmp(points[i].y - points[pivot].y) == 0 && dcmp(points[i].x - points[pivot].x) < 0)) {
-      pivot = i;
-    }
-  }
-    
-  std::swap(points[0], points[pivot]);
-  Point O = points[0];
-  
-  std::sort(points.begin() + 1, points.end(), [&](const Point& a, const Point& b){
-      Vector A = a - O, B = b - O;
-      int c = dcmp(cross(A, B));
-      if (c != 0) return c > 0;
-      return dcmp(length(A) - length(B)) < 0; 
-  });
-  
-  LinkedStack<Point> st;
-  st.push(points[0]);
-  st.push(points[1]);
-  for(int i = 2; i < N; ++i) {
-    while(st.size() >= 2 && dcmp(cross(st.second() - st.top(), points[i] - st.top())) <= 0) {
-      Point trash; st.pop(trash);
-    }
-    
-    st.push(points[i]);
-  }
-
-  std::vector <Point> hull;
-  Point t;
-  
-  while(st.pop(t)) hull.push_back(t);
-  reverse(hull.begin(), hull.end());
-
-  return hull;
-}
+#include <bits/stdc++.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "list.h"
+
+using i64 = long long;
+
+constexpr double eps = 1e-8;
+inline int dcmp(double a) {
+  if (fabs(a) < eps) return 0;
+  return a < 0 ? -1 : 1;
+}
+
+struct Point {
+  double x, y;
+  Point() {}
+  Point(double a, double b) : x(a), y(b) {}
+};
+
+typedef Point Vector;
+Vector operator +(Vector A, Vector B) {
+  return Vector(A.x + B.x, A.y + B.y);
+}
+
+Vector operator -(Vector A, Vector B) {
+  return Vector(A.x - B.x, A.y - B.y);
+}
+
+Vector operator *(Vector A, double p) {
+  return Vector(A.x * p, A.y * p);
+}
+
+Vector operator /(Vector A, double p) {
+  return Vector(A.x / p, A.y / p);
+}
+
+inline double dot(Vector A, Vector B) {
+  return A.x * B.x + A.y * B.y;
+}
+
+inline double cross(Vector A, Vector B) {
+  return A.x * B.y - A.y * B.x;
+}
+
+inline double length(Vector A) {
+  return sqrt(dot(A, A));
+}
+
+inline double angle(Vector A, Vector B) {
+  return acos(dot(A, B) / length(A) / length(B));
+}
+
+inline double dist(Point a, Point b) {
+  return sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+}
+
+inline Vector rotate(Point a, double t) {
+  return Vector(a.x * cos(t) - a.y * sin(t), a.x * sin(t) + a.y * cos(t));
+}
+
+std::vector<Point> Graham(std::vector<Point> points){
+  int N = points.size();
+  if (N <= 1) return points;
+
+  int pivot = 0;
+  for(int i = 1; i < N; ++i) {
+    if (dcmp(points[i].y - points[pivot].y) < 0 || (dcmp(points[i].y - points[pivot].y) == 0 && dcmp(points[i].x - points[pivot].x) < 0)) {
+      pivot = i;
+    }
+  }
+    
+  std::swap(points[0], points[pivot]);
+  Point O = points[0];
+  
+  std::sort(points.begin() + 1, points.end(), [&](const Point& a, const Point& b){
+      Vector A = a - O, B = b - O;
+      int c = dcmp(cross(A, B));
+      if (c != 0) return c > 0;
+      return dcmp(length(A) - length(B)) < 0; 
+  });
+  
+  SmallStack<Point> st;
+  st.push(points[0]);
+  st.push(points[1]);
+  for(int i = 2; i < N; ++i) {
+    while(st.size() >= 2 && dcmp(cross(st.top() - st.second(), points[i] - st.top())) <= 0) {
+      st.pop();
+    }
+    
+    st.push(points[i]);
+  }
+
+  auto hull = st.view();
+  return std::vector<Point>(hull.begin(), hull.end());
+}
+
+template <class C>
+concept Coord = std::integral<C> || std::floating_point<C>;
+
+template <class P>
+concept PlanarPoint = requires { P::x; P::y; } &&
+                      std::same_as<decltype(P::x), decltype(P::y)> &&
+                      Coord<decltype(P::x)>;
+
+template <PlanarPoint P>
+using coord_t = decltype(P::x);
+
+template <Coord C>
+struct BasicPoint {
+  C x, y;
+};
+
+namespace exact {
+
+template <std::integral C>
+int orient(C ax, C ay, C bx, C by, C cx, C cy) {
+  if constexpr (sizeof(C) <= 4) {
+    // Differences need 33 bits, so each product needs up to 66 bits and the result 67.
+    using i128 = __int128;
+    i128 d = i128(i64(bx) - ax) * (i64(cy) - ay) - i128(i64(by) - ay) * (i64(cx) - ax);
+    return (d > 0) - (d < 0);
+  } else {
+    using i128 = __int128;
+    using u128 = unsigned __int128;
+    auto mul = [](i128 p, i128 q) -> std::pair<int, u128> {
+      int s = (p > 0) - (p < 0);
+      if (q < 0) s = -s;
+      if (q == 0) s = 0;
+      u128 m = u128(p < 0 ? -p : p) * u128(q < 0 ? -q : q);
+      return {s, m};
+    };
+    auto [sl, ml] = mul(i128(bx) - ax, i128(cy) - ay);
+    auto [sr, mr] = mul(i128(by) - ay, i128(cx) - ax);
+    if (sl != sr) return sl > sr ? 1 : -1;
+    if (sl == 0 || ml == mr) return 0;
+    return (ml > mr) == (sl > 0) ? 1 : -1;
+  }
+}
+
+template <std::floating_point F>
+inline void two_sum(F a, F b, F& s, F& e) {
+  s = a + b;
+  F bv = s - a;
+  e = (a - (s - bv)) + (b - bv);
+}
+
+template <std::floating_point F>
+inline void two_product(F a, F b, F& p, F& e) {
+  p = a * b;
+  e = std::fma(a, b, -p);
+}
+
+template <std::floating_point C>
+int orient(C ax_, C ay_, C bx_, C by_, C cx_, C cy_) {
+  using F = std::conditional_t<std::is_same_v<C, float>, double, C>;
+  const F ax = ax_, ay = ay_, bx = bx_, by = by_, cx = cx_, cy = cy_;
+
+  const F detl = (bx - ax) * (cy - ay);
+  const F detr = (by - ay) * (cx - ax);
+  const F det = detl - detr;
+  const F u = std::numeric_limits<F>::epsilon() / 2;
+  const F bound = (3 + 16 * u) * u * (std::fabs(detl) + std::fabs(detr));
+  if (det > bound) return 1;
+  if (-det > bound) return -1;
+
+  // det = ax*by - ax*cy - ay*bx + ay*cx + bx*cy - by*cx, summed as an exact expansion.
+  const F terms[6][2] = {{ax, by}, {-ax, cy}, {-ay, bx}, {ay, cx}, {bx, cy}, {-by, cx}};
+  F h[12];
+  int n = 0;
+  auto grow = [&](F b) {
+    F q = b;
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+      F s, e;
+      two_sum(q, h[i], s, e);
+      q = s;
+      if (e != 0) h[m++] = e;
+    }
+    if (q != 0) h[m++] = q;
+    n = m;
+  };
+  for (auto& t : terms) {
+    F p, e;
+    two_product(t[0], t[1], p, e);
+    grow(e);
+    grow(p);
+  }
+  if (n == 0) return 0;
+  return h[n - 1] > 0 ? 1 : -1;
+}
+
+} // namespace exact
+
+template <PlanarPoint P>
+inline int orient(const P& a, const P& b, const P& c) {
+  return exact::orient<coord_t<P>>(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+struct HullOptions {
+  static constexpr std::size_t min_points_per_thread = 1 << 15;
+
+  bool prefilter = false;
+  unsigned threads = 1;
+};
+
+struct HullStats {
+  std::size_t input = 0;
+  std::size_t culled = 0;
+  bool simd = false;
+};
+
+namespace detail {
+
+// Order: min y, max x-y, max x, max x+y, max y, max y-x, min x, min x+y (counter-clockwise).
+template <PlanarPoint P>
+std::array<std::size_t, 8> extremes_scalar(const std::vector<P>& pts) {
+  using C = coord_t<P>;
+  using W = std::conditional_t<std::integral<C>, __int128, C>;
+  std::array<std::size_t, 8> id{};
+  std::array<W, 8> best;
+  auto score = [](const P& p) {
+    W x = p.x, y = p.y;
+    return std::array<W, 8>{-y, x - y, x, x + y, y, y - x, -x, -(x + y)};
+  };
+  best = score(pts[0]);
+  for (std::size_t i = 1; i < pts.size(); ++i) {
+    auto s = score(pts[i]);
+    for (int d = 0; d < 8; ++d) if (s[d] > best[d]) best[d] = s[d], id[d] = i;
+  }
+  return id;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+inline std::array<std::size_t, 8> extremes_avx2(const double* xy, std::size_t n) {
+  // Two points per register, lanes [x0, y0, x1, y1]; the swapped copy gives x+y and x-y / y-x.
+  const __m256d two = _mm256_set1_pd(2.0);
+  __m256d iv = _mm256_setr_pd(0, 0, 1, 1);
+  __m256d v = _mm256_loadu_pd(xy);
+  __m256d sw = _mm256_permute_pd(v, 0b0101);
+  __m256d vmax = v, vmin = v, dmax = _mm256_sub_pd(v, sw);
+  __m256d smax = _mm256_add_pd(v, sw), smin = smax;
+  __m256d ivmax = iv, ivmin = iv, idmax = iv, ismax = iv, ismin = iv;
+
+  for (std::size_t k = 1; k < n / 2; ++k) {
+    iv = _mm256_add_pd(iv, two);
+    v = _mm256_loadu_pd(xy + 4 * k);
+    sw = _mm256_permute_pd(v, 0b0101);
+    __m256d d = _mm256_sub_pd(v, sw), s = _mm256_add_pd(v, sw), m;
+    m = _mm256_cmp_pd(v, vmax, _CMP_GT_OQ); vmax = _mm256_blendv_pd(vmax, v, m); ivmax = _mm256_blendv_pd(ivmax, iv, m);
+    m = _mm256_cmp_pd(v, vmin, _CMP_LT_OQ); vmin = _mm256_blendv_pd(vmin, v, m); ivmin = _mm256_blendv_pd(ivmin, iv, m);
+    m = _mm256_cmp_pd(d, dmax, _CMP_GT_OQ); dmax = _mm256_blendv_pd(dmax, d, m); idmax = _mm256_blendv_pd(idmax, iv, m);
+    m = _mm256_cmp_pd(s, smax, _CMP_GT_OQ); smax = _mm256_blendv_pd(smax, s, m); ismax = _mm256_blendv_pd(ismax, iv, m);
+    m = _mm256_cmp_pd(s, smin, _CMP_LT_OQ); smin = _mm256_blendv_pd(smin, s, m); ismin = _mm256_blendv_pd(ismin, iv, m);
+  }
+
+  alignas(32) double a[10][4];
+  _mm256_store_pd(a[0], vmax); _mm256_store_pd(a[1], ivmax);
+  _mm256_store_pd(a[2], vmin); _mm256_store_pd(a[3], ivmin);
+  _mm256_store_pd(a[4], dmax); _mm256_store_pd(a[5], idmax);
+  _mm256_store_pd(a[6], smax); _mm256_store_pd(a[7], ismax);
+  _mm256_store_pd(a[8], smin); _mm256_store_pd(a[9], ismin);
+
+  std::array<std::size_t, 8> id{};
+  std::array<double, 8> best{};
+  auto take = [&](int d, int row, int lane, double sign) {
+    double val = sign * a[row][lane];
+    if (lane < 2 || val > best[d]) best[d] = val, id[d] = static_cast<std::size_t>(a[row + 1][lane]);
+  };
+  for (int lane : {1, 3}) take(0, 2, lane, -1);
+  for (int lane : {0, 2}) take(1, 4, lane, 1);
+  for (int lane : {0, 2}) take(2, 0, lane, 1);
+  for (int lane : {0, 2}) take(3, 6, lane, 1);
+  for (int lane : {1, 3}) take(4, 0, lane, 1);
+  for (int lane : {1, 3}) take(5, 4, lane, 1);
+  for (int lane : {0, 2}) take(6, 2, lane, -1);
+  for (int lane : {0, 2}) take(7, 8, lane, -1);
+
+  if (n % 2) {
+    const std::size_t i = n - 1;
+    const double x = xy[2 * i], y = xy[2 * i + 1];
+    const double s[8] = {-y, x - y, x, x + y, y, y - x, -x, -(x + y)};
+    for (int d = 0; d < 8; ++d) if (s[d] > best[d]) best[d] = s[d], id[d] = i;
+  }
+  return id;
+}
+#endif
+
+template <PlanarPoint P>
+std::array<std::size_t, 8> extremes(const std::vector<P>& pts, bool& simd) {
+#if defined(__x86_64__)
+  if constexpr (std::is_same_v<coord_t<P>, double> && std::is_standard_layout_v<P> &&
+                sizeof(P) == 2 * sizeof(double)) {
+    if (offsetof(P, x) == 0 && offsetof(P, y) == sizeof(double) &&
+        pts.size() >= 2 && __builtin_cpu_supports("avx2")) {
+      simd = true;
+      return extremes_avx2(reinterpret_cast<const double*>(pts.data()), pts.size());
+    }
+  }
+#endif
+  simd = false;
+  return extremes_scalar(pts);
+}
+
+template <PlanarPoint P>
+std::size_t akl_toussaint(std::vector<P>& pts, bool& simd) {
+  if (pts.size() < 8) return 0;
+  auto id = extremes(pts, simd);
+
+  std::vector<P> oct;
+  for (std::size_t i : id) {
+    const P& p = pts[i];
+    if (oct.empty() || p.x != oct.back().x || p.y != oct.back().y) oct.push_back(p);
+  }
+  while (oct.size() > 1 && oct.front().x == oct.back().x && oct.front().y == oct.back().y) oct.pop_back();
+  if (oct.size() < 3) return 0;
+
+  const std::size_t m = oct.size();
+  auto inside = [&](const P& p) {
+    for (std::size_t i = 0; i < m; ++i)
+      if (orient(oct[i], oct[(i + 1) % m], p) <= 0) return false;
+    return true;
+  };
+  return std::erase_if(pts, inside);
+}
+
+template <PlanarPoint P>
+std::vector<P> monotone_chain(std::span<P> points) {
+  auto key = [](const P& p) { return std::pair(p.x, p.y); };
+  std::ranges::sort(points, {}, key);
+  points = points.first(std::ranges::unique(points, {}, key).begin() - points.begin());
+
+  const std::size_t N = points.size();
+  if (N <= 2) return std::vector<P>(points.begin(), points.end());
+
+  std::vector<P> hull(2 * N);
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    while (k >= 2 && orient(hull[k - 2], hull[k - 1], points[i]) <= 0) --k;
+    hull[k++] = points[i];
+  }
+  for (std::size_t i = N - 1, lo = k + 1; i-- > 0; ) {
+    while (k >= lo && orient(hull[k - 2], hull[k - 1], points[i]) <= 0) --k;
+    hull[k++] = points[i];
+  }
+  hull.resize(k - 1);
+  return hull;
+}
+
+// Sub-hulls over contiguous slices, then one more pass over their vertices. The hull is unique
+// and Andrew always starts it at the lexicographic minimum, so the result equals the serial one.
+template <PlanarPoint P>
+std::vector<P> parallel_chain(std::vector<P>& points, unsigned threads) {
+  const std::size_t n = points.size(), chunk = (n + threads - 1) / threads;
+  std::vector<std::vector<P>> sub(threads);
+  std::vector<std::exception_ptr> err(threads);
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+      const std::size_t lo = std::min(n, t * chunk), hi = std::min(n, lo + chunk);
+      pool.emplace_back([&, t, lo, hi] {
+        try {
+          sub[t] = monotone_chain(std::span<P>(points).subspan(lo, hi - lo));
+        } catch (...) {
+          err[t] = std::current_exception();
+        }
+      });
+    }
+  }
+  for (auto& e : err) if (e) std::rethrow_exception(e);
+
+  std::vector<P> merged;
+  std::size_t total = 0;
+  for (auto& h : sub) total += h.size();
+  merged.reserve(total);
+  for (auto& h : sub) merged.insert(merged.end(), h.begin(), h.end());
+  return monotone_chain(std::span<P>(merged));
+}
+
+} // namespace detail
+
+template <PlanarPoint P>
+std::vector<P> Andrew(std::vector<P> points, HullOptions opt = {}, HullStats* stats = nullptr) {
+  if (stats) *stats = HullStats{points.size(), 0, false};
+  if (opt.prefilter) {
+    bool simd = false;
+    std::size_t culled = detail::akl_toussaint(points, simd);
+    if (stats) stats->culled = culled, stats->simd = simd;
+  }
+
+  unsigned threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned>(std::min<std::size_t>(threads, points.size() / HullOptions::min_points_per_thread));
+  if (threads > 1) return detail::parallel_chain(points, threads);
+  return detail::monotone_chain(std::span<P>(points));
+}
+
+template <PlanarPoint P, bool Upper>
+class HalfHull {
+  using C = coord_t<P>;
+  using W = std::conditional_t<std::integral<C>, __int128, C>;
+
+  struct Vertex {
+    P p;
+    mutable P nxt{};
+    mutable bool last = true;
+  };
+
+  struct Direction { W dx, dy; };
+
+  struct Less {
+    using is_transparent = void;
+    bool operator()(const Vertex& a, const Vertex& b) const { return a.p.x < b.p.x; }
+    bool operator()(const Vertex& a, C x) const { return a.p.x < x; }
+    bool operator()(C x, const Vertex& b) const { return x < b.p.x; }
+    // Vertices whose outgoing edge still gains along d; a prefix of the chain.
+    bool operator()(const Vertex& a, const Direction& d) const {
+      return !a.last && d.dx * (W(a.nxt.x) - a.p.x) + d.dy * (W(a.nxt.y) - a.p.y) > 0;
+    }
+  };
+
+  std::set<Vertex, Less> s_;
+
+  // Strictly convex in the chain's direction: a right turn for the upper chain, a left turn for the lower.
+  static bool convex(const P& a, const P& b, const P& c) {
+    int o = orient(a, b, c);
+    return Upper ? o < 0 : o > 0;
+  }
+  static bool dominates(C y, C other) { return Upper ? y > other : y < other; }
+
+  void relink(typename std::set<Vertex, Less>::iterator it) {
+    auto nx = std::next(it);
+    it->last = nx == s_.end();
+    if (!it->last) it->nxt = nx->p;
+  }
+
+public:
+  bool empty() const noexcept { return s_.empty(); }
+
+  bool insert(const P& p) {
+    auto it = s_.lower_bound(p.x);
+    if (it != s_.end() && it->p.x == p.x) {
+      if (!dominates(p.y, it->p.y)) return false;
+      it = s_.erase(it);
+    } else if (it != s_.end() && it != s_.begin() && !convex(std::prev(it)->p, p, it->p)) {
+      return false;
+    }
+
+    it = s_.insert(it, Vertex{p});
+    while (std::next(it) != s_.end() && std::next(it, 2) != s_.end() &&
+           !convex(p, std::next(it)->p, std::next(it, 2)->p))
+      s_.erase(std::next(it));
+    while (it != s_.begin() && std::prev(it) != s_.begin() &&
+           !convex(std::prev(it, 2)->p, std::prev(it)->p, p))
+      s_.erase(std::prev(it));
+
+    relink(it);
+    if (it != s_.begin()) relink(std::prev(it));
+    return true;
+  }
+
+  bool covers(const P& q) const {
+    auto it = s_.lower_bound(q.x);
+    if (it == s_.end()) return false;
+    if (it->p.x == q.x) return !dominates(q.y, it->p.y);
+    if (it == s_.begin()) return false;
+    int o = orient(std::prev(it)->p, it->p, q);
+    return Upper ? o <= 0 : o >= 0;
+  }
+
+  const P& extreme(C dx, C dy) const { return s_.lower_bound(Direction{dx, dy})->p; }
+
+  auto begin() const { return s_.begin(); }
+  auto end() const { return s_.end(); }
+};
+
+template <PlanarPoint P>
+class DynamicHull {
+  using C = coord_t<P>;
+
+  HalfHull<P, true> upper_;
+  HalfHull<P, false> lower_;
+
+  static bool same(const P& a, const P& b) { return a.x == b.x && a.y == b.y; }
+
+public:
+  DynamicHull() = default;
+
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_value_t<R>, P>
+  explicit DynamicHull(R&& r) {
+    for (auto&& p : r) insert(p);
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return upper_.empty(); }
+
+  // Returns true when p changed the hull, i.e. it was not already inside or on it.
+  bool insert(const P& p) {
+    bool u = upper_.insert(p);
+    bool l = lower_.insert(p);
+    return u || l;
+  }
+
+  [[nodiscard]] bool contains(const P& q) const { return upper_.covers(q) && lower_.covers(q); }
+
+  // The hull vertex touched by the supporting line with outward normal (dx, dy).
+  [[nodiscard]] const P& tangent(C dx, C dy) const {
+    if (empty()) throw std::runtime_error("tangent() on empty hull");
+    if (dx == 0 && dy == 0) throw std::invalid_argument("tangent() needs a non-zero direction");
+    return dy < 0 ? lower_.extreme(dx, dy) : upper_.extreme(dx, dy);
+  }
+
+  // Same vertex order as Andrew: counter-clockwise from the lexicographic minimum.
+  [[nodiscard]] std::vector<P> snapshot() const {
+    std::vector<P> hull;
+    for (auto& v : lower_) hull.push_back(v.p);
+    if (hull.empty()) return hull;
+    const P first = hull.front();
+    for (auto it = std::make_reverse_iterator(upper_.end()); it != std::make_reverse_iterator(upper_.begin()); ++it) {
+      if (!same(it->p, hull.back()) && !same(it->p, first)) hull.push_back(it->p);
+    }
+    return hull;
+  }
+};
+
+// Rotating calipers over a counter-clockwise hull without collinear vertices (Graham / Andrew output).
+
+struct Rect {
+  double area = 0, perimeter = 0;
+  std::array<Point, 4> corner;
+};
+
+double diameter(const std::vector<Point>& h) {
+  const int n = h.size();
+  if (n <= 1) return 0;
+  if (n == 2) return dist(h[0], h[1]);
+  double best = 0;
+  for (int i = 0, j = 1; i < n; ++i) {
+    Vector e = h[(i + 1) % n] - h[i];
+    while (cross(e, h[(j + 1) % n] - h[i]) > cross(e, h[j] - h[i])) j = (j + 1) % n;
+    best = std::max({best, dist(h[i], h[j]), dist(h[(i + 1) % n], h[j])});
+  }
+  return best;
+}
+
+double width(const std::vector<Point>& h) {
+  const int n = h.size();
+  if (n <= 2) return 0;
+  double best = std::numeric_limits<double>::infinity();
+  for (int i = 0, j = 1; i < n; ++i) {
+    Vector e = h[(i + 1) % n] - h[i];
+    while (cross(e, h[(j + 1) % n] - h[i]) > cross(e, h[j] - h[i])) j = (j + 1) % n;
+    best = std::min(best, cross(e, h[j] - h[i]) / length(e));
+  }
+  return best;
+}
+
+namespace detail {
+
+template <class Cost>
+Rect calipers_rect(const std::vector<Point>& h, Cost cost) {
+  const int n = h.size();
+  Rect best;
+  if (n == 0) return best;
+  if (n == 1) {
+    best.corner.fill(h[0]);
+    return best;
+  }
+
+  auto at = [&](int k) -> const Point& { return h[k % n]; };
+  int j = 0, k = 0, m = 0;
+  {
+    Vector e = h[1] - h[0];
+    for (int t = 1; t < n; ++t) {
+      if (cross(e, h[t] - h[0]) > cross(e, h[j] - h[0])) j = t;
+      if (dot(e, h[t]) > dot(e, h[k])) k = t;
+      if (dot(e, h[t]) < dot(e, h[m])) m = t;
+    }
+  }
+
+  bool found = false;
+  for (int i = 0; i < n; ++i) {
+    const Point& base = h[i];
+    Vector e = at(i + 1) - base;
+    while (cross(e, at(j + 1) - base) > cross(e, at(j) - base)) j = (j + 1) % n;
+    while (dot(e, at(k + 1)) > dot(e, at(k))) k = (k + 1) % n;
+    while (dot(e, at(m + 1)) < dot(e, at(m))) m = (m + 1) % n;
+
+    const double len = length(e);
+    Vector u = e / len, nrm(-u.y, u.x);
+    const double lo = dot(at(m) - base, u), hi = dot(at(k) - base, u);
+    const double ht = cross(u, at(j) - base);
+
+    Rect r;
+    r.area = (hi - lo) * ht;
+    r.perimeter = 2 * ((hi - lo) + ht);
+    r.corner = {base + u * lo, base + u * hi, base + u * hi + nrm * ht, base + u * lo + nrm * ht};
+    if (!found || cost(r) < cost(best)) best = r, found = true;
+  }
+  return best;
+}
+
+inline double point_segment_dist(Point p, Point a, Point b) {
+  Vector ab = b - a;
+  double l2 = dot(ab, ab);
+  if (l2 == 0) return length(p - a);
+  double t = std::clamp(dot(p - a, ab) / l2, 0.0, 1.0);
+  return length(p - (a + ab * t));
+}
+
+} // namespace detail
+
+Rect min_area_rect(const std::vector<Point>& h) {
+  return detail::calipers_rect(h, [](const Rect& r) { return r.area; });
+}
+
+Rect min_perimeter_rect(const std::vector<Point>& h) {
+  return detail::calipers_rect(h, [](const Rect& r) { return r.perimeter; });
+}
+
+// Distance from the origin to the Minkowski difference A - B, merged edge by edge in O(|A| + |B|).
+double hull_distance(const std::vector<Point>& A, const std::vector<Point>& B) {
+  if (A.empty() || B.empty()) throw std::invalid_argument("hull_distance() on empty hull");
+
+  auto prepare = [](std::vector<Point> P) {
+    auto lowest = std::min_element(P.begin(), P.end(), [](const Point& a, const Point& b) {
+      return a.y < b.y || (a.y == b.y && a.x < b.x);
+    });
+    std::rotate(P.begin(), lowest, P.end());
+    P.push_back(P[0]);
+    P.push_back(P[1 % (P.size() - 1)]);
+    return P;
+  };
+  std::vector<Point> nb(B.size());
+  std::transform(B.begin(), B.end(), nb.begin(), [](const Point& p) { return Point(-p.x, -p.y); });
+  const std::vector<Point> P = prepare(A), Q = prepare(std::move(nb));
+
+  std::vector<Point> M;
+  M.reserve(A.size() + B.size());
+  for (std::size_t i = 0, j = 0; i < P.size() - 2 || j < Q.size() - 2; ) {
+    M.push_back(P[i] + Q[j]);
+    double c = cross(P[i + 1] - P[i], Q[j + 1] - Q[j]);
+    if (c >= 0 && i < P.size() - 2) ++i;
+    if (c <= 0 && j < Q.size() - 2) ++j;
+  }
+
+  const Point O(0, 0);
+  const int m = M.size();
+  if (m >= 3) {
+    bool inside = true;
+    for (int i = 0; i < m && inside; ++i) inside = dcmp(cross(M[(i + 1) % m] - M[i], O - M[i])) >= 0;
+    if (inside) return 0;
+  }
+  if (m == 1) return length(M[0]);
+  double best = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < m; ++i) best = std::min(best, detail::point_segment_dist(O, M[i], M[(i + 1) % m]));
+  return best;
+}
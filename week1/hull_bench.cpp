@@ -0,0 +1,363 @@
+#include "convex-hull.cpp"
+
+// Usage: hull_bench --check
+//        hull_bench --bench [max_n]   hull engines, then rotating calipers vs O(h^2)
+// --check exits non-zero if any check fails.
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+double seconds(F&& f) {
+  auto t0 = Clock::now();
+  f();
+  std::chrono::duration<double> dt = Clock::now() - t0;
+  return dt.count();
+}
+
+// Uniform in a square (small hull) or in a disk (hull grows like n^(1/3)).
+std::vector<Point> random_points(std::size_t n, bool disk, std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> u(-1e6, 1e6);
+  std::vector<Point> pts;
+  pts.reserve(n);
+  while (pts.size() < n) {
+    Point p(u(rng), u(rng));
+    if (!disk || p.x * p.x + p.y * p.y <= 1e12) pts.push_back(p);
+  }
+  return pts;
+}
+
+// O(h^2) references for the calipers queries.
+namespace brute {
+
+double diameter(const std::vector<Point>& h) {
+  double best = 0;
+  for (std::size_t i = 0; i < h.size(); ++i)
+    for (std::size_t j = i + 1; j < h.size(); ++j) best = std::max(best, dist(h[i], h[j]));
+  return best;
+}
+
+struct Flush {
+  double width, area, perimeter;
+};
+
+// For every edge: farthest vertex (width) and extent along the edge, which give the flush rectangle.
+Flush flush_rects(const std::vector<Point>& h) {
+  const std::size_t n = h.size();
+  const double inf = std::numeric_limits<double>::infinity();
+  Flush best{inf, inf, inf};
+  for (std::size_t i = 0; i < n; ++i) {
+    const Vector e = h[(i + 1) % n] - h[i];
+    const Vector u = e / length(e);
+    double ht = 0, lo = 0, hi = 0;
+    for (const Point& p : h) {
+      ht = std::max(ht, cross(u, p - h[i]));
+      lo = std::min(lo, dot(u, p - h[i]));
+      hi = std::max(hi, dot(u, p - h[i]));
+    }
+    best.width = std::min(best.width, ht);
+    best.area = std::min(best.area, ht * (hi - lo));
+    best.perimeter = std::min(best.perimeter, 2 * (ht + (hi - lo)));
+  }
+  return best;
+}
+
+// 0 when the hulls touch or overlap, otherwise the closest vertex-edge pair.
+double distance(const std::vector<Point>& a, const std::vector<Point>& b) {
+  auto inside = [](const std::vector<Point>& h, Point p) {
+    if (h.size() < 3) return false;
+    for (std::size_t i = 0; i < h.size(); ++i)
+      if (cross(h[(i + 1) % h.size()] - h[i], p - h[i]) < 0) return false;
+    return true;
+  };
+  for (const Point& p : a) if (inside(b, p)) return 0;
+  for (const Point& q : b) if (inside(a, q)) return 0;
+
+  double best = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const Point p1 = a[i], p2 = a[(i + 1) % a.size()];
+    for (std::size_t j = 0; j < b.size(); ++j) {
+      const Point q1 = b[j], q2 = b[(j + 1) % b.size()];
+      if (cross(p2 - p1, q1 - p1) * cross(p2 - p1, q2 - p1) < 0 &&
+          cross(q2 - q1, p1 - q1) * cross(q2 - q1, p2 - q1) < 0)
+        return 0;
+      best = std::min({best, detail::point_segment_dist(p1, q1, q2), detail::point_segment_dist(q1, p1, p2)});
+    }
+  }
+  return best;
+}
+
+} // namespace brute
+
+// Byte-for-byte equality: both hulls must list the same vertices from the same start.
+template <class P>
+bool same_hull(const std::vector<P>& a, const std::vector<P>& b) {
+  return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(P)) == 0;
+}
+
+// Points that survive Akl-Toussaint: on or outside the octagon through the first point found
+// extreme along each of the eight directions.
+template <class P>
+std::size_t octagon_survivors(const std::vector<P>& pts) {
+  if (pts.size() < 8) return pts.size();
+  using W = std::conditional_t<std::integral<coord_t<P>>, __int128, coord_t<P>>;
+  constexpr int dir[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+  std::vector<P> oct;
+  for (const auto& [dx, dy] : dir) {
+    auto score = [&](const P& p) { return W(dx) * W(p.x) + W(dy) * W(p.y); };
+    const P& e = *std::ranges::max_element(pts, [&](const P& a, const P& b) { return score(a) < score(b); });
+    if (oct.empty() || e.x != oct.back().x || e.y != oct.back().y) oct.push_back(e);
+  }
+  while (oct.size() > 1 && oct.front().x == oct.back().x && oct.front().y == oct.back().y) oct.pop_back();
+  if (oct.size() < 3) return pts.size();
+  return std::ranges::count_if(pts, [&](const P& p) {
+    for (std::size_t i = 0; i < oct.size(); ++i)
+      if (orient(oct[i], oct[(i + 1) % oct.size()], p) <= 0) return true;
+    return false;
+  });
+}
+
+// q in the convex polygon h (Andrew order, no collinear vertices), boundary included.
+template <class P>
+bool hull_contains(const std::vector<P>& h, const P& q) {
+  if (h.empty()) return false;
+  if (h.size() == 1) return q.x == h[0].x && q.y == h[0].y;
+  if (h.size() == 2)
+    return orient(h[0], h[1], q) == 0 && std::min(h[0].x, h[1].x) <= q.x && q.x <= std::max(h[0].x, h[1].x) &&
+           std::min(h[0].y, h[1].y) <= q.y && q.y <= std::max(h[0].y, h[1].y);
+  for (std::size_t i = 0; i < h.size(); ++i)
+    if (orient(h[i], h[(i + 1) % h.size()], q) < 0) return false;
+  return true;
+}
+
+int check() {
+  int failures = 0;
+  auto expect = [&](bool ok, const char* what) {
+    if (!ok) {
+      std::printf("FAIL %s\n", what);
+      ++failures;
+    }
+  };
+
+  using P32 = BasicPoint<std::int32_t>;
+  using P64 = BasicPoint<std::int64_t>;
+  constexpr std::int32_t lo = std::numeric_limits<std::int32_t>::min(), hi = std::numeric_limits<std::int32_t>::max();
+
+  // Full-range int32 corners: each product is about 2^64, the difference about 2^65.
+  expect(orient(P32{lo, lo}, P32{hi, lo}, P32{lo, hi}) == 1, "orient int32 corners ccw");
+  expect(orient(P32{lo, lo}, P32{lo, hi}, P32{hi, lo}) == -1, "orient int32 corners cw");
+  expect(orient(P32{lo, lo}, P32{0, 0}, P32{hi, hi}) == 0, "orient int32 diagonal");
+  // (0, 0) lies just outside the hypotenuse x + y = -1; (lo / 2, lo / 2) is interior.
+  expect(Andrew(std::vector<P32>{{lo, lo}, {hi, lo}, {lo, hi}, {0, 0}}).size() == 4, "Andrew int32 corners + (0, 0)");
+  expect(Andrew(std::vector<P32>{{lo, lo}, {hi, lo}, {lo, hi}, {lo / 2, lo / 2}}).size() == 3,
+         "Andrew int32 corners + interior");
+
+  // The 32-bit and 64-bit paths are independent; they must agree on full-range inputs.
+  std::mt19937_64 rng(7);
+  auto edge = [&]() -> std::int32_t {
+    switch (rng() % 4) {
+      case 0: return lo + static_cast<std::int32_t>(rng() % 4);
+      case 1: return hi - static_cast<std::int32_t>(rng() % 4);
+      case 2: return static_cast<std::int32_t>(rng() % 7) - 3;
+      default: return static_cast<std::int32_t>(rng());
+    }
+  };
+  int mismatches = 0;
+  for (int i = 0; i < 1'000'000; ++i) {
+    P32 a{edge(), edge()}, b{edge(), edge()}, c{edge(), edge()};
+    if (orient(a, b, c) != orient(P64{a.x, a.y}, P64{b.x, b.y}, P64{c.x, c.y})) ++mismatches;
+  }
+  expect(mismatches == 0, "orient int32 agrees with int64");
+
+  // The prefilter must not change the hull, and must report what it culled and which path ran.
+  bool avx2 = false;
+#if defined(__x86_64__)
+  avx2 = __builtin_cpu_supports("avx2");
+#endif
+  auto prefilter_case = [&]<class P>(const char* name, const std::vector<P>& pts, bool simd) {
+    HullStats st;
+    const auto h = Andrew(pts, {.prefilter = true}, &st);
+    char what[96];
+    std::snprintf(what, sizeof what, "prefilter %s: same hull", name);
+    expect(same_hull(h, Andrew(pts)), what);
+    std::snprintf(what, sizeof what, "prefilter %s: culled == input - survivors", name);
+    expect(st.input == pts.size() && st.culled == pts.size() - octagon_survivors(pts), what);
+    std::snprintf(what, sizeof what, "prefilter %s: simd path", name);
+    expect(st.simd == simd, what);
+    return st.culled;
+  };
+  for (std::size_t n : {7, 8, 9, 1'000, 100'000}) {
+    for (bool disk : {false, true}) {
+      const auto pts = random_points(n, disk, rng);
+      std::vector<P32> ipts(n);
+      for (std::size_t i = 0; i < n; ++i)
+        ipts[i] = {static_cast<std::int32_t>(pts[i].x * 1000), static_cast<std::int32_t>(pts[i].y * 1000)};
+      const std::size_t culled = prefilter_case(disk ? "disk" : "square", pts, avx2 && n >= 8);
+      prefilter_case(disk ? "int32 disk" : "int32 square", ipts, false);
+      if (n >= 1'000) expect(culled > n / 2, "prefilter culls most of a random cloud");
+    }
+    // Every extreme ties with the whole line, so nothing is strictly inside the octagon.
+    std::vector<Point> line(n);
+    for (auto& p : line) {
+      const double x = static_cast<double>(static_cast<std::int64_t>(rng() % 2'000'001) - 1'000'000);
+      p = Point(x, 3 * x - 7);
+    }
+    expect(prefilter_case("collinear", line, avx2 && n >= 8) == 0, "prefilter culls nothing on a line");
+  }
+
+  // DynamicHull against Andrew on every prefix boundary of a stream. Small grids give duplicates
+  // and collinear runs; `line` points come first and keep the hull degenerate for a while.
+  auto dynamic_case = [&]<class P>(const char* name, std::int64_t range, std::size_t n, std::size_t line) {
+    auto coord = [&] { return static_cast<coord_t<P>>(static_cast<std::int64_t>(rng() % (2 * range + 1)) - range); };
+    std::vector<P> pts(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      pts[i].x = coord();
+      pts[i].y = i < line ? 2 * pts[i].x + 1 : coord();
+    }
+    DynamicHull<P> dh;
+    int snapshot_bad = 0, contains_bad = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      dh.insert(pts[i]);
+      if (i >= 32 && i % 37 != 0 && i + 1 != n) continue;
+      const std::vector<P> prefix(pts.begin(), pts.begin() + i + 1);
+      const auto ref = Andrew(prefix);
+      if (!same_hull(dh.snapshot(), ref)) ++snapshot_bad;
+      std::vector<P> queries(ref);
+      for (std::size_t k = 0; k < ref.size(); ++k) {
+        const P& a = ref[k];
+        const P& b = ref[(k + 1) % ref.size()];
+        queries.push_back({std::midpoint(a.x, b.x), std::midpoint(a.y, b.y)});
+      }
+      for (int k = 0; k < 64; ++k) queries.push_back({coord(), coord()});
+      for (const P& q : queries)
+        if (dh.contains(q) != hull_contains(ref, q)) ++contains_bad;
+    }
+    char what[96];
+    std::snprintf(what, sizeof what, "DynamicHull %s: snapshot equals Andrew of the prefix", name);
+    expect(snapshot_bad == 0, what);
+    std::snprintf(what, sizeof what, "DynamicHull %s: contains agrees with orient", name);
+    expect(contains_bad == 0, what);
+  };
+  dynamic_case.operator()<P64>("int64 grid", 30, 3'000, 0);
+  dynamic_case.operator()<P64>("int64 line first", 30, 3'000, 50);
+  dynamic_case.operator()<P64>("int64 wide", 1'000'000'000'000, 3'000, 20);
+  dynamic_case.operator()<P32>("int32 full range", hi, 3'000, 0);
+  dynamic_case.operator()<Point>("double grid", 1'000, 3'000, 20);
+
+  // Calipers perimeter and Minkowski distance against the brute-force references, on small hulls
+  // (down to single points and segments) that are sometimes apart and sometimes overlapping.
+  {
+    std::uniform_int_distribution<int> coord(-50, 50), shift(-150, 150), size(1, 12);
+    int apart = 0, overlap = 0, perimeter_bad = 0, distance_bad = 0;
+    auto cloud = [&](int dx, int dy) {
+      std::vector<Point> pts(size(rng));
+      for (auto& p : pts) p = Point(coord(rng) + dx, coord(rng) + dy);
+      return Andrew(pts);
+    };
+    for (int t = 0; t < 20'000; ++t) {
+      const auto a = cloud(0, 0), b = cloud(shift(rng), shift(rng));
+      if (a.size() >= 3) {
+        const double p = min_perimeter_rect(a).perimeter, bp = brute::flush_rects(a).perimeter;
+        if (std::abs(p - bp) > 1e-9 * bp) ++perimeter_bad;
+      }
+      const double d = hull_distance(a, b), bd = brute::distance(a, b);
+      (bd == 0 ? overlap : apart) += 1;
+      if (std::abs(d - bd) > 1e-9 * std::max(1.0, bd)) ++distance_bad;
+    }
+    expect(perimeter_bad == 0, "min_perimeter_rect matches the per-edge minimum");
+    expect(distance_bad == 0, "hull_distance matches the closest vertex-edge pair");
+    expect(apart > 1'000 && overlap > 1'000, "hull_distance cases cover both apart and overlapping");
+  }
+
+  // Every slice must hold at least min_points_per_thread points, so these sizes give k real threads.
+  for (std::size_t n : {4 * HullOptions::min_points_per_thread + 1, std::size_t{200'003}, std::size_t{500'000}}) {
+    for (bool disk : {false, true}) {
+      const auto pts = random_points(n, disk, rng);
+      std::vector<P32> ipts(n);
+      for (std::size_t i = 0; i < n; ++i)
+        ipts[i] = {static_cast<std::int32_t>(pts[i].x * 1000), static_cast<std::int32_t>(pts[i].y * 1000)};
+      const auto serial = Andrew(pts);
+      const auto iserial = Andrew(ipts);
+      for (unsigned k : {2, 3, 4}) {
+        expect(same_hull(Andrew(pts, {.threads = k}), serial), "parallel double hull equals serial");
+        expect(same_hull(Andrew(ipts, {.threads = k}), iserial), "parallel int32 hull equals serial");
+      }
+    }
+  }
+
+  std::printf("%s\n", failures ? "check failed" : "all checks passed");
+  return failures ? 1 : 0;
+}
+
+void bench_calipers() {
+  std::mt19937_64 rng(13);
+  std::uniform_real_distribution<double> angle(0, 2 * std::acos(-1.0));
+  std::printf("\n%6s %12s %12s %11s %11s %11s\n", "hull", "calipers s", "O(h^2) s", "max rel err", "perim err",
+              "dist err");
+  for (std::size_t h : {1'000, 4'000, 16'000}) {
+    // Points on an ellipse are all hull vertices.
+    std::vector<Point> pts(h);
+    for (auto& p : pts) {
+      const double t = angle(rng);
+      p = Point(1e6 * std::cos(t), 4e5 * std::sin(t));
+    }
+    const std::vector<Point> hull = Andrew(pts);
+    // A rotated copy well clear of the first, so the distance is positive.
+    std::vector<Point> other(hull.size());
+    for (std::size_t i = 0; i < hull.size(); ++i) other[i] = rotate(hull[i], 1.0) + Vector(2.5e6, 1.5e6);
+    other = Andrew(other);
+
+    double d = 0, w = 0, a = 0, p = 0, hd = 0;
+    const double tc = seconds([&] {
+      d = diameter(hull);
+      w = width(hull);
+      a = min_area_rect(hull).area;
+      p = min_perimeter_rect(hull).perimeter;
+      hd = hull_distance(hull, other);
+    });
+    double bd = 0, bhd = 0;
+    brute::Flush bf;
+    const double tb = seconds([&] {
+      bd = brute::diameter(hull);
+      bf = brute::flush_rects(hull);
+      bhd = brute::distance(hull, other);
+    });
+    const double err = std::max({std::abs(d - bd) / bd, std::abs(w - bf.width) / bf.width,
+                                 std::abs(a - bf.area) / bf.area});
+    std::printf("%6zu %12.6f %12.6f %11.1e %11.1e %11.1e\n", hull.size(), tc, tb, err,
+                std::abs(p - bf.perimeter) / bf.perimeter, std::abs(hd - bhd) / bhd);
+  }
+}
+
+void bench(std::size_t max_n) {
+  std::mt19937_64 rng(11);
+  const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+  std::printf("%-7s %10s %6s %10s %10s %11s %10s %7s %10s\n", "shape", "n", "hull", "Graham s", "Andrew s",
+              "prefilter s", "int32 s", "threads", "parallel s");
+  for (std::size_t n = 1'000'000; n <= max_n; n *= 10)
+    for (bool disk : {false, true}) {
+      const auto pts = random_points(n, disk, rng);
+      std::vector<BasicPoint<std::int32_t>> ipts(n);
+      for (std::size_t i = 0; i < n; ++i)
+        ipts[i] = {static_cast<std::int32_t>(pts[i].x * 1000), static_cast<std::int32_t>(pts[i].y * 1000)};
+      std::size_t hg = 0, ha = 0, hp = 0, ht = 0;
+      const double tg = seconds([&] { hg = Graham(pts).size(); });
+      const double ta = seconds([&] { ha = Andrew(pts).size(); });
+      const double tp = seconds([&] { hp = Andrew(pts, {.prefilter = true}).size(); });
+      const double ti = seconds([&] { (void)Andrew(ipts); });
+      const double tt = seconds([&] { ht = Andrew(pts, {.threads = threads}).size(); });
+      std::printf("%-7s %10zu %6zu %10.3f %10.3f %11.3f %10.3f %7u %10.3f%s\n", disk ? "disk" : "square", n, ha, tg,
+                  ta, tp, ti, threads, tt, hg == ha && hp == ha && ht == ha ? "" : "  hull sizes differ");
+    }
+}
+
+int main(int argc, char** argv) {
+  const std::string_view mode = argc > 1 ? argv[1] : "";
+  if (mode == "--check") return check();
+  if (mode == "--bench") {
+    bench(argc > 2 ? std::stoull(argv[2]) : 10'000'000);
+    bench_calipers();
+    return 0;
+  }
+  std::fprintf(stderr, "usage: hull_bench --check|--bench [max_n]\n");
+  return 2;
+}
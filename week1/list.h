@@ -1,153 +1,625 @@
-#include <bits/stdc++.h>
-
-using i64 = long long;
-
-template <class T> requires std::movable<T>   
-class LinkedList {
-  struct Node {
-    T value;
-    std::unique_ptr<Node> next;
-    explicit Node(T v) : value(std::move(v)), next(nullptr) {}
-  };
-
-  std::unique_ptr<Node> head_;
-  Node* tail_ = nullptr; 
-  std::size_t size_ = 0;
-
-	public:
-    LinkedList() = default;
-    LinkedList(const LinkedList&) = delete;            
-    LinkedList& operator=(const LinkedList&) = delete;
-    LinkedList(LinkedList&&) noexcept = default;
-    LinkedList& operator=(LinkedList&&) noexcept = default;
-
-    ~LinkedList() { clear(); }
-
-    bool empty() const noexcept { return size_ == 0; }
-    std::size_t size() const noexcept { return size_; }
-
-    T& front() {
-      if (empty()) throw std::runtime_error("front() on empty list");
-      return head_->value;
-    }
-    const T& front() const {
-      if (empty()) throw std::runtime_error("front() on empty list");
-      return head_->value;
-    }
-    T& back() {
-      if (empty()) throw std::runtime_error("back() on empty list");
-      return tail_->value;
-    }
-    const T& back() const {
-      if (empty()) throw std::runtime_error("back() on empty list");
-      return tail_->value;
-    }
-    
-    void push_front(T value) {
-      auto node = std::make_unique<Node>(std::move(value));
-      node->next = std::move(head_);
-      head_ = std::move(node);
-      if (!tail_) tail_ = head_.get();
-      ++size_;
-    }
-
-    void push_back(T value) {
-      auto node = std::make_unique<Node>(std::move(value));
-      Node* raw = node.get();
-      if (tail_) {
-        tail_->next = std::move(node);
-        tail_ = raw;
-      } else {
-        head_ = std::move(node);
-        tail_ = head_.get();
-      }
-      ++size_;
-    }
-    
-    bool pop_front(T& out) {
-      if (empty()) return false;
-      out = std::move(head_->value);
-      auto old = std::move(head_);
-      head_ = std::move(old->next);
-      if (!head_) tail_ = nullptr;
-      --size_;
-      return true;
-    }
-
-  void clear() noexcept {
-    while (head_) {
-      auto next = std::move(head_->next);
-      head_.reset();
-      head_ = std::move(next);
-    }
-    tail_ = nullptr;
-    size_ = 0;
-  }
-};
-
-template <class T> requires std::movable<T>
-class LinkedQueue {
-    LinkedList<T> list_;
-	public:
-  	LinkedQueue() = default;
-
-  template <std::ranges::input_range R>
-    requires std::convertible_to<std::ranges::range_value_t<R>, T>
-  explicit LinkedQueue(R&& r) {
-    for (auto&& x : r) enqueue(static_cast<T>(x));
-  }
-
-  bool empty() const noexcept { return list_.empty(); }
-  std::size_t size() const noexcept { return list_.size(); }
-
-  void enqueue(T value) { list_.push_back(std::move(value)); }
-  bool dequeue(T& out)  { return list_.pop_front(out); }
-
-  T& front() { return list_.front(); }
-  const T& front() const { return list_.front(); }
-  T& back() { return list_.back(); }
-  const T& back() const { return list_.back(); }
-
-  void clear() noexcept { list_.clear(); }
-};
-
-template <class T>
-class LinkedStack {
-  struct Node { 
-    T val; 
-    Node* next; 
-    Node(const T& v, Node* n) : val(v), next(n) {} 
-  };
-  Node* head_ = nullptr; 
-  size_t sz_ = 0;
-
-  public:
-    ~LinkedStack() { clear(); }
-    bool empty() const { return sz_ == 0; }
-    size_t size() const { return sz_; }
-
-    void push(const T& v) { head_ = new Node(v, head_); ++sz_; }
-    bool pop(T& out) {
-      if(empty()) return false;
-      Node* p=head_; 
-      out=p->val;
-      head_=p->next; 
-      delete p; 
-      --sz_; 
-      
-      return true;
-    }
-    
-    T& top() { return head_->val; }
-    T& second() { return head_->next->val; }
-    void clear() { 
-      while(head_) { 
-        Node* n=head_->next; 
-        delete head_; 
-        head_=n; 
-      }
-
-      size_=0; 
-    }
-};
-
+#include <bits/stdc++.h>
+
+using i64 = long long;
+
+template <class Node>
+class NodePool {
+  union Slot {
+    Slot* next;
+    alignas(Node) std::byte storage[sizeof(Node)];
+  };
+  struct Slab {
+    Slab* prev;
+    std::size_t bytes;
+  };
+
+  static constexpr std::size_t header_ = (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+  static constexpr std::size_t align_ = std::max(alignof(Slab), alignof(Slot));
+  static constexpr std::size_t min_slots_ = 32;
+  static constexpr std::size_t max_slots_ = 4096;
+
+  std::pmr::memory_resource* upstream_;
+  Slab* slabs_ = nullptr;
+  Slot* free_ = nullptr;
+  Slot* cursor_ = nullptr;
+  Slot* end_ = nullptr;
+  std::size_t next_slots_ = min_slots_;
+
+  void grow() {
+    const std::size_t bytes = header_ + next_slots_ * sizeof(Slot);
+    void* mem = upstream_->allocate(bytes, align_);
+    slabs_ = ::new (mem) Slab{slabs_, bytes};
+    cursor_ = reinterpret_cast<Slot*>(static_cast<std::byte*>(mem) + header_);
+    end_ = cursor_ + next_slots_;
+    next_slots_ = std::min(next_slots_ * 2, max_slots_);
+  }
+
+  public:
+    explicit NodePool(std::pmr::memory_resource* mr = std::pmr::get_default_resource()) noexcept
+      : upstream_(mr ? mr : std::pmr::get_default_resource()) {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    NodePool(NodePool&& o) noexcept
+      : upstream_(o.upstream_),
+        slabs_(std::exchange(o.slabs_, nullptr)),
+        free_(std::exchange(o.free_, nullptr)),
+        cursor_(std::exchange(o.cursor_, nullptr)),
+        end_(std::exchange(o.end_, nullptr)),
+        next_slots_(std::exchange(o.next_slots_, min_slots_)) {}
+    NodePool& operator=(NodePool&& o) noexcept {
+      if (this != &o) {
+        release();
+        upstream_ = o.upstream_;
+        slabs_ = std::exchange(o.slabs_, nullptr);
+        free_ = std::exchange(o.free_, nullptr);
+        cursor_ = std::exchange(o.cursor_, nullptr);
+        end_ = std::exchange(o.end_, nullptr);
+        next_slots_ = std::exchange(o.next_slots_, min_slots_);
+      }
+      return *this;
+    }
+    ~NodePool() { release(); }
+
+    std::pmr::memory_resource* resource() const noexcept { return upstream_; }
+
+    template <class... Args>
+    Node* create(Args&&... args) {
+      Slot* s;
+      if (free_) {
+        s = free_;
+        free_ = free_->next;
+      } else {
+        if (cursor_ == end_) grow();
+        s = cursor_++;
+      }
+      try {
+        return ::new (static_cast<void*>(s->storage)) Node(std::forward<Args>(args)...);
+      } catch (...) {
+        s->next = free_;
+        free_ = s;
+        throw;
+      }
+    }
+
+    void destroy(Node* n) noexcept {
+      n->~Node();
+      Slot* s = reinterpret_cast<Slot*>(n);
+      s->next = free_;
+      free_ = s;
+    }
+
+    // Hands every slab back to the upstream resource; live nodes must already be destroyed.
+    void release() noexcept {
+      while (slabs_) {
+        Slab* prev = slabs_->prev;
+        upstream_->deallocate(slabs_, slabs_->bytes, align_);
+        slabs_ = prev;
+      }
+      free_ = cursor_ = end_ = nullptr;
+      next_slots_ = min_slots_;
+    }
+};
+
+template <class T> requires std::movable<T>
+class LinkedList {
+  struct Node {
+    T value;
+    Node* next;
+    explicit Node(T v) : value(std::move(v)), next(nullptr) {}
+  };
+
+  NodePool<Node> pool_;
+  Node* head_ = nullptr;
+  Node* tail_ = nullptr;
+  std::size_t size_ = 0;
+
+	public:
+    LinkedList() = default;
+    explicit LinkedList(std::pmr::memory_resource* mr) noexcept : pool_(mr) {}
+    LinkedList(const LinkedList&) = delete;
+    LinkedList& operator=(const LinkedList&) = delete;
+    LinkedList(LinkedList&& o) noexcept
+      : pool_(std::move(o.pool_)),
+        head_(std::exchange(o.head_, nullptr)),
+        tail_(std::exchange(o.tail_, nullptr)),
+        size_(std::exchange(o.size_, 0)) {}
+    LinkedList& operator=(LinkedList&& o) noexcept {
+      if (this != &o) {
+        clear();
+        pool_ = std::move(o.pool_);
+        head_ = std::exchange(o.head_, nullptr);
+        tail_ = std::exchange(o.tail_, nullptr);
+        size_ = std::exchange(o.size_, 0);
+      }
+      return *this;
+    }
+
+    ~LinkedList() { clear(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t size() const noexcept { return size_; }
+    std::pmr::memory_resource* resource() const noexcept { return pool_.resource(); }
+
+    T& front() {
+      if (empty()) throw std::runtime_error("front() on empty list");
+      return head_->value;
+    }
+    const T& front() const {
+      if (empty()) throw std::runtime_error("front() on empty list");
+      return head_->value;
+    }
+    T& back() {
+      if (empty()) throw std::runtime_error("back() on empty list");
+      return tail_->value;
+    }
+    const T& back() const {
+      if (empty()) throw std::runtime_error("back() on empty list");
+      return tail_->value;
+    }
+
+    void push_front(T value) {
+      Node* node = pool_.create(std::move(value));
+      node->next = head_;
+      head_ = node;
+      if (!tail_) tail_ = head_;
+      ++size_;
+    }
+
+    void push_back(T value) {
+      Node* node = pool_.create(std::move(value));
+      if (tail_) {
+        tail_->next = node;
+        tail_ = node;
+      } else {
+        head_ = tail_ = node;
+      }
+      ++size_;
+    }
+
+    bool pop_front(T& out) {
+      if (empty()) return false;
+      out = std::move(head_->value);
+      Node* old = head_;
+      head_ = old->next;
+      if (!head_) tail_ = nullptr;
+      pool_.destroy(old);
+      --size_;
+      return true;
+    }
+
+  void clear() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (Node* n = head_; n; n = n->next) n->value.~T();
+    }
+    pool_.release();
+    head_ = tail_ = nullptr;
+    size_ = 0;
+  }
+};
+
+template <class T, std::size_t B = 64> requires std::movable<T>
+class UnrolledList {
+  static_assert(B > 0 && std::has_single_bit(B));
+
+  std::pmr::memory_resource* mr_;
+  std::vector<T*> map_;
+  T* spare_ = nullptr;
+  std::size_t begin_ = 0;
+  std::size_t size_ = 0;
+
+  T* slot(std::size_t pos) const noexcept { return map_[pos / B] + pos % B; }
+
+  T* take_block() {
+    if (spare_) return std::exchange(spare_, nullptr);
+    return static_cast<T*>(mr_->allocate(B * sizeof(T), alignof(T)));
+  }
+  void give_block(T* blk) noexcept {
+    if (!spare_) spare_ = blk;
+    else mr_->deallocate(blk, B * sizeof(T), alignof(T));
+  }
+
+  void recenter(bool at_front) {
+    std::size_t first = begin_ / B;
+    std::size_t last = size_ ? (begin_ + size_ - 1) / B + 1 : first;
+    std::size_t used = last - first;
+    std::size_t want = std::max<std::size_t>(8, 2 * (used + 1));
+    std::size_t at = (want - used) / 2 + (at_front ? 1 : 0);
+    if (map_.size() >= want) {
+      std::vector<T*> tmp(map_.begin() + first, map_.begin() + last);
+      std::fill(map_.begin(), map_.end(), nullptr);
+      std::copy(tmp.begin(), tmp.end(), map_.begin() + at);
+    } else {
+      std::vector<T*> bigger(want, nullptr);
+      std::copy(map_.begin() + first, map_.begin() + last, bigger.begin() + at);
+      map_.swap(bigger);
+    }
+    begin_ = begin_ - first * B + at * B;
+  }
+
+  template <bool Const>
+  class Iter {
+    using List = std::conditional_t<Const, const UnrolledList, UnrolledList>;
+    List* l_ = nullptr;
+    std::size_t i_ = 0;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+
+    Iter() = default;
+    Iter(List* l, std::size_t i) : l_(l), i_(i) {}
+    operator Iter<true>() const requires (!Const) { return {l_, i_}; }
+
+    reference operator*() const { return *l_->slot(l_->begin_ + i_); }
+    pointer operator->() const { return l_->slot(l_->begin_ + i_); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    Iter& operator++() { ++i_; return *this; }
+    Iter operator++(int) { auto t = *this; ++i_; return t; }
+    Iter& operator--() { --i_; return *this; }
+    Iter operator--(int) { auto t = *this; --i_; return t; }
+    Iter& operator+=(difference_type n) { i_ += n; return *this; }
+    Iter& operator-=(difference_type n) { i_ -= n; return *this; }
+    friend Iter operator+(Iter it, difference_type n) { return it += n; }
+    friend Iter operator+(difference_type n, Iter it) { return it += n; }
+    friend Iter operator-(Iter it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const Iter& a, const Iter& b) {
+      return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+    }
+    friend bool operator==(const Iter& a, const Iter& b) { return a.i_ == b.i_; }
+    friend auto operator<=>(const Iter& a, const Iter& b) { return a.i_ <=> b.i_; }
+  };
+
+	public:
+    using value_type = T;
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    UnrolledList() : UnrolledList(nullptr) {}
+    explicit UnrolledList(std::pmr::memory_resource* mr) noexcept
+      : mr_(mr ? mr : std::pmr::get_default_resource()) {}
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+    UnrolledList(UnrolledList&& o) noexcept
+      : mr_(o.mr_),
+        map_(std::move(o.map_)),
+        spare_(std::exchange(o.spare_, nullptr)),
+        begin_(std::exchange(o.begin_, 0)),
+        size_(std::exchange(o.size_, 0)) { o.map_.clear(); }
+    UnrolledList& operator=(UnrolledList&& o) noexcept {
+      if (this != &o) {
+        clear();
+        release_blocks();
+        mr_ = o.mr_;
+        map_ = std::move(o.map_);
+        o.map_.clear();
+        spare_ = std::exchange(o.spare_, nullptr);
+        begin_ = std::exchange(o.begin_, 0);
+        size_ = std::exchange(o.size_, 0);
+      }
+      return *this;
+    }
+
+    ~UnrolledList() { clear(); release_blocks(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t size() const noexcept { return size_; }
+    std::pmr::memory_resource* resource() const noexcept { return mr_; }
+
+    T& front() {
+      if (empty()) throw std::runtime_error("front() on empty list");
+      return *slot(begin_);
+    }
+    const T& front() const {
+      if (empty()) throw std::runtime_error("front() on empty list");
+      return *slot(begin_);
+    }
+    T& back() {
+      if (empty()) throw std::runtime_error("back() on empty list");
+      return *slot(begin_ + size_ - 1);
+    }
+    const T& back() const {
+      if (empty()) throw std::runtime_error("back() on empty list");
+      return *slot(begin_ + size_ - 1);
+    }
+    T& operator[](std::size_t i) { return *slot(begin_ + i); }
+    const T& operator[](std::size_t i) const { return *slot(begin_ + i); }
+
+    void push_front(T value) {
+      if (begin_ == 0) recenter(true);
+      std::size_t pos = begin_ - 1;
+      if (!map_[pos / B]) map_[pos / B] = take_block();
+      ::new (static_cast<void*>(slot(pos))) T(std::move(value));
+      begin_ = pos;
+      ++size_;
+    }
+
+    void push_back(T value) {
+      std::size_t pos = begin_ + size_;
+      if (pos / B >= map_.size()) {
+        recenter(false);
+        pos = begin_ + size_;
+      }
+      if (!map_[pos / B]) map_[pos / B] = take_block();
+      ::new (static_cast<void*>(slot(pos))) T(std::move(value));
+      ++size_;
+    }
+
+    bool pop_front(T& out) {
+      if (empty()) return false;
+      T* p = slot(begin_);
+      out = std::move(*p);
+      p->~T();
+      ++begin_;
+      --size_;
+      if (begin_ % B == 0 || empty()) {
+        std::size_t blk = (begin_ - 1) / B;
+        give_block(map_[blk]);
+        map_[blk] = nullptr;
+        if (empty()) begin_ = map_.size() / 2 * B;
+      }
+      return true;
+    }
+
+    bool pop_back(T& out) {
+      if (empty()) return false;
+      std::size_t pos = begin_ + size_ - 1;
+      T* p = slot(pos);
+      out = std::move(*p);
+      p->~T();
+      --size_;
+      if (pos % B == 0 || empty()) {
+        give_block(map_[pos / B]);
+        map_[pos / B] = nullptr;
+        if (empty()) begin_ = map_.size() / 2 * B;
+      }
+      return true;
+    }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size_}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size_}; }
+
+    template <class F>
+    void for_each_chunk(F f) {
+      for (std::size_t pos = begin_, left = size_; left; ) {
+        std::size_t n = std::min(B - pos % B, left);
+        f(std::span<T>(slot(pos), n));
+        pos += n;
+        left -= n;
+      }
+    }
+    template <class F>
+    void for_each_chunk(F f) const {
+      for (std::size_t pos = begin_, left = size_; left; ) {
+        std::size_t n = std::min(B - pos % B, left);
+        f(std::span<const T>(slot(pos), n));
+        pos += n;
+        left -= n;
+      }
+    }
+
+  void clear() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (std::size_t i = 0; i < size_; ++i) slot(begin_ + i)->~T();
+    }
+    for (auto& blk : map_) {
+      if (blk) mr_->deallocate(blk, B * sizeof(T), alignof(T));
+      blk = nullptr;
+    }
+    begin_ = map_.size() / 2 * B;
+    size_ = 0;
+  }
+
+  private:
+    void release_blocks() noexcept {
+      if (spare_) mr_->deallocate(std::exchange(spare_, nullptr), B * sizeof(T), alignof(T));
+    }
+};
+
+template <class T, class Storage = LinkedList<T>> requires std::movable<T>
+class LinkedQueue {
+    Storage list_;
+	public:
+  	LinkedQueue() = default;
+    explicit LinkedQueue(std::pmr::memory_resource* mr) noexcept : list_(mr) {}
+
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_value_t<R>, T>
+  explicit LinkedQueue(R&& r, std::pmr::memory_resource* mr = nullptr) : list_(mr) {
+    for (auto&& x : r) enqueue(static_cast<T>(x));
+  }
+
+  bool empty() const noexcept { return list_.empty(); }
+  std::size_t size() const noexcept { return list_.size(); }
+
+  void enqueue(T value) { list_.push_back(std::move(value)); }
+  bool dequeue(T& out)  { return list_.pop_front(out); }
+
+  T& front() { return list_.front(); }
+  const T& front() const { return list_.front(); }
+  T& back() { return list_.back(); }
+  const T& back() const { return list_.back(); }
+
+  void clear() noexcept { list_.clear(); }
+};
+
+template <class T, std::size_t B = 64>
+using UnrolledQueue = LinkedQueue<T, UnrolledList<T, B>>;
+
+template <class T>
+class LinkedStack {
+  struct Node {
+    T val;
+    Node* next;
+    Node(const T& v, Node* n) : val(v), next(n) {}
+    Node(T&& v, Node* n) : val(std::move(v)), next(n) {}
+  };
+  NodePool<Node> pool_;
+  Node* head_ = nullptr;
+  size_t sz_ = 0;
+
+  public:
+    LinkedStack() = default;
+    explicit LinkedStack(std::pmr::memory_resource* mr) noexcept : pool_(mr) {}
+    LinkedStack(const LinkedStack&) = delete;
+    LinkedStack& operator=(const LinkedStack&) = delete;
+    ~LinkedStack() { clear(); }
+    bool empty() const { return sz_ == 0; }
+    size_t size() const { return sz_; }
+
+    void push(const T& v) { head_ = pool_.create(v, head_); ++sz_; }
+    void push(T&& v) { head_ = pool_.create(std::move(v), head_); ++sz_; }
+    bool pop(T& out) {
+      if(empty()) return false;
+      Node* p=head_;
+      out=std::move(p->val);
+      head_=p->next;
+      pool_.destroy(p);
+      --sz_;
+
+      return true;
+    }
+
+    T& top() { return head_->val; }
+    T& second() { return head_->next->val; }
+    void clear() {
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (Node* n = head_; n; n = n->next) n->val.~T();
+      }
+      pool_.release();
+      head_ = nullptr;
+      sz_=0;
+    }
+};
+
+template <class T, std::size_t N = 16> requires std::movable<T>
+class SmallStack {
+  static_assert(N > 0);
+
+  alignas(T) std::byte inline_[N * sizeof(T)];
+  T* data_ = reinterpret_cast<T*>(inline_);
+  std::size_t sz_ = 0;
+  std::size_t cap_ = N;
+
+  bool on_heap() const noexcept { return data_ != reinterpret_cast<const T*>(inline_); }
+
+  // Copies instead of moving when the move may throw (like std::vector), so a failure part way
+  // leaves the current elements intact.
+  void transfer(T* p) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+      std::uninitialized_move(data_, data_ + sz_, p);
+    else
+      std::uninitialized_copy(data_, data_ + sz_, p);
+  }
+
+  void adopt(T* p, std::size_t cap) noexcept {
+    std::destroy(data_, data_ + sz_);
+    if (on_heap()) std::allocator<T>{}.deallocate(data_, cap_);
+    data_ = p;
+    cap_ = cap;
+  }
+
+  void relocate(std::size_t cap) {
+    T* p = std::allocator<T>{}.allocate(cap);
+    try {
+      transfer(p);
+    } catch (...) {
+      std::allocator<T>{}.deallocate(p, cap);
+      throw;
+    }
+    adopt(p, cap);
+  }
+
+  // args may refer into the current buffer (push(top())), so the new element is built in the
+  // new buffer before the old elements are moved out.
+  template <class... Args>
+  T& grow_emplace(Args&&... args) {
+    const std::size_t cap = cap_ * 2;
+    T* p = std::allocator<T>{}.allocate(cap);
+    T* e = nullptr;
+    try {
+      e = ::new (static_cast<void*>(p + sz_)) T(std::forward<Args>(args)...);
+      transfer(p);
+    } catch (...) {
+      if (e) std::destroy_at(e);
+      std::allocator<T>{}.deallocate(p, cap);
+      throw;
+    }
+    adopt(p, cap);
+    ++sz_;
+    return *e;
+  }
+
+  void steal(SmallStack& o) noexcept {
+    if (o.on_heap()) {
+      data_ = std::exchange(o.data_, reinterpret_cast<T*>(o.inline_));
+      cap_ = std::exchange(o.cap_, N);
+    } else {
+      std::uninitialized_move(o.data_, o.data_ + o.sz_, data_);
+      std::destroy(o.data_, o.data_ + o.sz_);
+    }
+    sz_ = std::exchange(o.sz_, 0);
+  }
+
+  public:
+    SmallStack() = default;
+    SmallStack(const SmallStack&) = delete;
+    SmallStack& operator=(const SmallStack&) = delete;
+    SmallStack(SmallStack&& o) noexcept(std::is_nothrow_move_constructible_v<T>) { steal(o); }
+    SmallStack& operator=(SmallStack&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+      if (this != &o) {
+        clear();
+        if (on_heap()) std::allocator<T>{}.deallocate(data_, cap_);
+        data_ = reinterpret_cast<T*>(inline_);
+        cap_ = N;
+        steal(o);
+      }
+      return *this;
+    }
+    ~SmallStack() {
+      clear();
+      if (on_heap()) std::allocator<T>{}.deallocate(data_, cap_);
+    }
+
+    bool empty() const noexcept { return sz_ == 0; }
+    size_t size() const noexcept { return sz_; }
+    size_t capacity() const noexcept { return cap_; }
+
+    void reserve(std::size_t cap) { if (cap > cap_) relocate(cap); }
+
+    template <class... Args>
+    T& emplace(Args&&... args) {
+      if (sz_ == cap_) return grow_emplace(std::forward<Args>(args)...);
+      T* p = ::new (static_cast<void*>(data_ + sz_)) T(std::forward<Args>(args)...);
+      ++sz_;
+      return *p;
+    }
+    void push(const T& v) { emplace(v); }
+    void push(T&& v) { emplace(std::move(v)); }
+
+    bool pop(T& out) {
+      if (empty()) return false;
+      out = std::move(data_[sz_ - 1]);
+      pop();
+      return true;
+    }
+    void pop() noexcept { std::destroy_at(data_ + --sz_); }
+
+    T& top() { return data_[sz_ - 1]; }
+    T& second() { return data_[sz_ - 2]; }
+    const T& top() const { return data_[sz_ - 1]; }
+    const T& second() const { return data_[sz_ - 2]; }
+
+    std::span<T> view() noexcept { return {data_, sz_}; }
+    std::span<const T> view() const noexcept { return {data_, sz_}; }
+
+    void clear() noexcept {
+      std::destroy(data_, data_ + sz_);
+      sz_ = 0;
+    }
+};
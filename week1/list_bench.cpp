@@ -0,0 +1,395 @@
+#include "list.h"
+
+// Usage: list_bench --check
+//        list_bench --bench [n]
+// --check covers SmallStack, UnrolledList and UnrolledQueue and exits non-zero if any check fails.
+// --bench reports ns per operation for the pooled
+// LinkedQueue/LinkedStack against one heap allocation per node.
+
+using Clock = std::chrono::steady_clock;
+
+// The previous design: every push allocates a node, every pop frees it.
+template <class T>
+class HeapQueue {
+  struct Node {
+    T value;
+    std::unique_ptr<Node> next;
+    explicit Node(T v) : value(std::move(v)) {}
+  };
+  std::unique_ptr<Node> head_;
+  Node* tail_ = nullptr;
+
+public:
+  ~HeapQueue() { clear(); }
+  void enqueue(T v) {
+    auto n = std::make_unique<Node>(std::move(v));
+    Node* raw = n.get();
+    if (tail_) tail_->next = std::move(n);
+    else head_ = std::move(n);
+    tail_ = raw;
+  }
+  bool dequeue(T& out) {
+    if (!head_) return false;
+    out = std::move(head_->value);
+    head_ = std::move(head_->next);
+    if (!head_) tail_ = nullptr;
+    return true;
+  }
+  void clear() noexcept {
+    while (head_) head_ = std::move(head_->next);
+    tail_ = nullptr;
+  }
+};
+
+template <class T>
+class HeapStack {
+  struct Node {
+    T val;
+    Node* next;
+  };
+  Node* head_ = nullptr;
+
+public:
+  ~HeapStack() { clear(); }
+  void push(T v) { head_ = new Node{std::move(v), head_}; }
+  bool pop(T& out) {
+    if (!head_) return false;
+    Node* p = head_;
+    out = std::move(p->val);
+    head_ = p->next;
+    delete p;
+    return true;
+  }
+  void clear() noexcept {
+    while (head_) delete std::exchange(head_, head_->next);
+  }
+};
+
+struct Row {
+  double burst, steady, clear;
+};
+
+// burst: n pushes then n pops; steady: n push/pop pairs at depth 1024; clear: drop n elements.
+template <class Q, class Push, class Pop>
+Row measure(Q& q, std::size_t n, Push push, Pop pop) {
+  auto ns = [&](auto t0, std::size_t ops) {
+    std::chrono::duration<double, std::nano> dt = Clock::now() - t0;
+    return dt.count() / static_cast<double>(ops);
+  };
+  std::uint64_t sink = 0, v = 0;
+  Row r;
+
+  auto t0 = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) push(q, i);
+  for (std::size_t i = 0; i < n; ++i) pop(q, v), sink += v;
+  r.burst = ns(t0, 2 * n);
+
+  for (std::size_t i = 0; i < 1024; ++i) push(q, i);
+  t0 = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    push(q, i);
+    pop(q, v);
+    sink += v;
+  }
+  r.steady = ns(t0, 2 * n);
+  while (pop(q, v)) sink += v;
+
+  for (std::size_t i = 0; i < n; ++i) push(q, i);
+  t0 = Clock::now();
+  q.clear();
+  r.clear = ns(t0, n);
+
+  if (sink == 42) std::printf(" ");
+  return r;
+}
+
+void bench(std::size_t n) {
+  auto enq = [](auto& q, std::uint64_t x) { q.enqueue(x); };
+  auto deq = [](auto& q, std::uint64_t& x) { return q.dequeue(x); };
+  auto push = [](auto& s, std::uint64_t x) { s.push(x); };
+  auto pop = [](auto& s, std::uint64_t& x) { return s.pop(x); };
+
+  std::printf("n = %zu, ns/op          burst   steady    clear\n", n);
+  auto print = [](const char* name, Row r) {
+    std::printf("%-24s %8.2f %8.2f %8.2f\n", name, r.burst, r.steady, r.clear);
+  };
+  {
+    HeapQueue<std::uint64_t> q;
+    print("queue, heap per node", measure(q, n, enq, deq));
+  }
+  {
+    LinkedQueue<std::uint64_t> q;
+    print("LinkedQueue, pool", measure(q, n, enq, deq));
+  }
+  {
+    std::pmr::unsynchronized_pool_resource mr;
+    LinkedQueue<std::uint64_t> q(&mr);
+    print("LinkedQueue, pmr pool", measure(q, n, enq, deq));
+  }
+  {
+    HeapStack<std::uint64_t> s;
+    print("stack, heap per node", measure(s, n, push, pop));
+  }
+  {
+    LinkedStack<std::uint64_t> s;
+    print("LinkedStack, pool", measure(s, n, push, pop));
+  }
+}
+
+// Counts live instances. Copies and moves throw once `budget` reaches zero; the move is not
+// noexcept, so SmallStack has to copy when it grows.
+struct Tracked {
+  static inline int live = 0, budget = -1;
+  std::string s;
+
+  static void tick() {
+    if (budget == 0) throw std::runtime_error("Tracked: budget exhausted");
+    if (budget > 0) --budget;
+  }
+  explicit Tracked(std::string v) : s(std::move(v)) { ++live; }
+  Tracked(const Tracked& o) : s(o.s) { tick(); ++live; }
+  Tracked(Tracked&& o) : s(std::move(o.s)) { tick(); ++live; }
+  Tracked& operator=(const Tracked&) = default;
+  Tracked& operator=(Tracked&&) = default;
+  ~Tracked() { --live; }
+};
+
+// Tracks outstanding bytes so a leaked or double-freed block shows up.
+struct CountingResource : std::pmr::memory_resource {
+  std::ptrdiff_t bytes = 0;
+
+  void* do_allocate(std::size_t n, std::size_t a) override {
+    bytes += n;
+    return std::pmr::new_delete_resource()->allocate(n, a);
+  }
+  void do_deallocate(void* p, std::size_t n, std::size_t a) override {
+    bytes -= n;
+    std::pmr::new_delete_resource()->deallocate(p, n, a);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+};
+
+int check() {
+  int failures = 0;
+  auto expect = [&](bool ok, const char* what) {
+    if (!ok) {
+      std::printf("FAIL %s\n", what);
+      ++failures;
+    }
+  };
+
+  // SmallStack: inline, then doubling on the heap; the view is bottom to top.
+  {
+    SmallStack<std::string, 4> st;
+    std::vector<std::string> ref;
+    bool tops = true;
+    for (int i = 0; i < 100; ++i) {
+      std::string v = "value " + std::to_string(i) + std::string(i % 7 * 8, '*');
+      tops &= st.emplace(v) == v;
+      ref.push_back(v);
+      if (i >= 1) tops &= st.second() == ref[i - 1];
+    }
+    expect(tops, "SmallStack emplace returns the new top, second() the one below");
+    expect(std::ranges::equal(st.view(), ref), "SmallStack view after growth");
+    expect(st.capacity() == 128, "SmallStack doubles from N");
+
+    // At every capacity boundary the argument lives in the buffer being replaced.
+    SmallStack<std::string, 4> self;
+    self.push(std::string(40, 'x'));
+    bool alias = true;
+    for (int i = 1; i < 40; ++i) {
+      self.push(self.top());
+      alias &= self.top() == std::string(40, 'x') && self.size() == static_cast<std::size_t>(i + 1);
+    }
+    expect(alias, "SmallStack push(top()) across growth");
+
+    std::string out;
+    bool order = true;
+    for (int i = 99; i >= 60; --i) order &= st.pop(out) && out == ref[i];
+    ref.resize(60);
+    expect(order, "SmallStack pop order");
+    st.reserve(500);
+    expect(st.capacity() == 500 && std::ranges::equal(st.view(), ref), "SmallStack reserve keeps elements");
+
+    SmallStack<std::string, 4> heap(std::move(st)), small;
+    expect(st.empty() && std::ranges::equal(heap.view(), ref), "SmallStack move from heap buffer");
+    for (int i = 0; i < 3; ++i) small.push(ref[i]);
+    SmallStack<std::string, 4> moved(std::move(small));
+    expect(small.empty() && moved.size() == 3 && moved.top() == ref[2], "SmallStack move from inline buffer");
+    heap = std::move(moved);
+    expect(moved.empty() && heap.size() == 3 && heap.capacity() == 4 && heap.view()[0] == ref[0],
+           "SmallStack move assignment");
+    expect(!moved.pop(out), "SmallStack pop on empty");
+  }
+
+  // A copy that throws while the stack grows must leave it as it was, with nothing leaked.
+  {
+    SmallStack<Tracked, 4> st;
+    for (int i = 0; i < 4; ++i) st.emplace("t" + std::to_string(i));
+    const Tracked extra("extra");
+    const int live = Tracked::live;
+    Tracked::budget = 3;
+    bool threw = false;
+    try {
+      st.push(extra);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    Tracked::budget = -1;
+    auto intact = [&](std::size_t n) {
+      bool ok = st.size() == n;
+      for (std::size_t i = 0; i < n && ok; ++i) ok = st.view()[i].s == "t" + std::to_string(i);
+      return ok;
+    };
+    expect(threw && Tracked::live == live && intact(4) && st.capacity() == 4, "SmallStack grow failure is rolled back");
+
+    for (int i = 4; i < 8; ++i) st.emplace("t" + std::to_string(i));
+    Tracked::budget = 5;
+    threw = false;
+    try {
+      st.reserve(64);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    Tracked::budget = -1;
+    expect(threw && Tracked::live == live + 4 && intact(8) && st.capacity() == 8,
+           "SmallStack reserve failure is rolled back");
+    st.push(extra);
+    expect(st.size() == 9 && st.top().s == "extra", "SmallStack grows after a failed attempt");
+  }
+  expect(Tracked::live == 0, "SmallStack destroys every element");
+
+  // UnrolledList against std::deque with tiny blocks, so nearly every operation is at or next to a
+  // block boundary. Phases lean toward one end, which walks the window across the map and forces
+  // recenter() and map growth in both directions.
+  {
+    constexpr std::size_t B = 4;
+    CountingResource mr;
+    {
+      UnrolledList<std::string, B> l(&mr);
+      std::deque<std::string> ref;
+      std::mt19937_64 rng(5);
+      int mismatch = 0, chunk_bad = 0, hoarding = 0;
+      auto compare = [&] {
+        if (!std::ranges::equal(l, ref)) ++mismatch;
+        for (std::size_t i = 0; i < ref.size(); i += 7) if (l[i] != ref[i]) ++mismatch;
+
+        // Chunks are whole blocks apart from the two ends, and together they are the list.
+        std::vector<std::size_t> sizes;
+        std::vector<std::string> joined;
+        std::as_const(l).for_each_chunk([&](std::span<const std::string> c) {
+          sizes.push_back(c.size());
+          joined.insert(joined.end(), c.begin(), c.end());
+        });
+        for (std::size_t i = 0; i < sizes.size(); ++i)
+          if (sizes[i] == 0 || sizes[i] > B || (i > 0 && i + 1 < sizes.size() && sizes[i] != B)) ++chunk_bad;
+        if (sizes.size() > ref.size() / B + 2 || !std::ranges::equal(joined, ref)) ++chunk_bad;
+
+        // Blocks in use plus the one spare; emptied blocks must go back.
+        if (mr.bytes > static_cast<std::ptrdiff_t>((ref.size() / B + 3) * B * sizeof(std::string))) ++hoarding;
+      };
+
+      std::string out;
+      for (int phase = 0; phase < 60; ++phase) {
+        const unsigned lean = rng() % 4;  // 0 front grows, 1 back grows, 2 front drains, 3 back drains
+        const int steps = static_cast<int>(rng() % 300);
+        for (int k = 0; k < steps; ++k) {
+          const unsigned op = rng() % 4 == 0 ? rng() % 4 : lean;
+          const std::string v = std::to_string(phase) + ":" + std::to_string(k);
+          if (op == 0) l.push_front(v), ref.push_front(v);
+          else if (op == 1) l.push_back(v), ref.push_back(v);
+          else if (op == 2) {
+            if (l.pop_front(out) != !ref.empty() || (!ref.empty() && out != ref.front())) ++mismatch;
+            if (!ref.empty()) ref.pop_front();
+          } else {
+            if (l.pop_back(out) != !ref.empty() || (!ref.empty() && out != ref.back())) ++mismatch;
+            if (!ref.empty()) ref.pop_back();
+          }
+          if (l.size() != ref.size() || (!ref.empty() && (l.front() != ref.front() || l.back() != ref.back())))
+            ++mismatch;
+          if (k % 13 == 0) compare();
+        }
+        compare();
+      }
+      expect(mismatch == 0, "UnrolledList matches std::deque");
+      expect(chunk_bad == 0, "UnrolledList for_each_chunk yields whole blocks");
+      expect(hoarding == 0, "UnrolledList returns emptied blocks");
+
+      // Draining to empty from the back and refilling from the front reuses the reset window.
+      while (l.pop_back(out)) {}
+      ref.clear();
+      for (int i = 0; i < 50; ++i) l.push_front(std::to_string(i)), ref.push_front(std::to_string(i));
+      compare();
+      expect(mismatch == 0 && chunk_bad == 0, "UnrolledList refill after draining");
+
+      UnrolledList<std::string, B> moved(std::move(l));
+      expect(l.empty() && std::ranges::equal(moved, ref), "UnrolledList move construction");
+      l.push_back("again");
+      l = std::move(moved);
+      expect(moved.empty() && std::ranges::equal(l, ref), "UnrolledList move assignment");
+      std::ranges::sort(l);
+      std::ranges::sort(ref);
+      expect(std::ranges::equal(l, ref), "UnrolledList iterators sort");
+      bool threw = false;
+      try {
+        (void)moved.front();
+      } catch (const std::runtime_error&) {
+        threw = true;
+      }
+      expect(threw, "UnrolledList front() on empty throws");
+    }
+    expect(mr.bytes == 0, "UnrolledList frees every block");
+  }
+
+  // UnrolledQueue keeps FIFO order across blocks and works with move-only values.
+  {
+    CountingResource mr;
+    {
+      std::vector<int> init(20);
+      std::iota(init.begin(), init.end(), 0);
+      UnrolledQueue<std::unique_ptr<int>, 8> q(&mr);
+      std::deque<int> ref(init.begin(), init.end());
+      for (int x : init) q.enqueue(std::make_unique<int>(x));
+      std::mt19937_64 rng(9);
+      int mismatch = 0, next = 20;
+      std::unique_ptr<int> out;
+      for (int k = 0; k < 20'000; ++k) {
+        if (rng() % 5 < 2) {
+          const bool got = q.dequeue(out);
+          if (got != !ref.empty() || (got && *out != ref.front())) ++mismatch;
+          if (!ref.empty()) ref.pop_front();
+        } else {
+          q.enqueue(std::make_unique<int>(next));
+          ref.push_back(next++);
+        }
+        if (q.size() != ref.size() || (!ref.empty() && (*q.front() != ref.front() || *q.back() != ref.back())))
+          ++mismatch;
+      }
+      while (q.dequeue(out)) {
+        if (ref.empty() || *out != ref.front()) ++mismatch;
+        if (!ref.empty()) ref.pop_front();
+      }
+      expect(mismatch == 0 && ref.empty(), "UnrolledQueue matches FIFO order");
+
+      UnrolledQueue<int, 8> from_range(init, &mr);
+      int x = -1;
+      bool ok = from_range.size() == init.size();
+      for (int v : init) ok &= from_range.dequeue(x) && x == v;
+      expect(ok && from_range.empty(), "UnrolledQueue range constructor");
+    }
+    expect(mr.bytes == 0, "UnrolledQueue frees every block");
+  }
+
+  std::printf("%s\n", failures ? "check failed" : "all checks passed");
+  return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::string_view(argv[1]) == "--check") return check();
+  if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+    bench(argc > 2 ? std::stoull(argv[2]) : 10'000'000);
+    return 0;
+  }
+  std::fprintf(stderr, "usage: list_bench --check|--bench [n]\n");
+  return 2;
+}
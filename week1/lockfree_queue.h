@@ -0,0 +1,356 @@
+#pragma once
+#include <bits/stdc++.h>
+
+namespace lockfree {
+
+class HazardDomain {
+public:
+  static constexpr std::size_t max_threads = 256;
+  static constexpr std::size_t slots = 2;
+
+private:
+  struct Retired {
+    void* p;
+    void (*deleter)(void*);
+  };
+
+  // One per (thread, domain); `retired` is only touched by the owning thread.
+  struct alignas(64) Record {
+    std::atomic<bool> active{false};
+    std::atomic<void*> hp[slots]{};
+    std::vector<Retired> retired;
+  };
+
+  // Threads remember which record they hold in each domain. A thread exiting after a domain
+  // died must not touch it, so live domains are tracked by a never-reused id.
+  struct Binding {
+    HazardDomain* domain;
+    std::uint64_t id;
+    Record* rec;
+  };
+
+  struct Registry {
+    std::mutex m;
+    std::unordered_set<std::uint64_t> live;
+    std::uint64_t next_id = 0;
+  };
+
+  static Registry& registry() {
+    static Registry r;
+    return r;
+  }
+
+  struct ThreadBindings {
+    std::vector<Binding> v;
+    ~ThreadBindings() {
+      std::lock_guard lk(registry().m);
+      for (auto& b : v)
+        if (registry().live.contains(b.id)) b.domain->release(*b.rec);
+    }
+  };
+
+  static ThreadBindings& bindings() {
+    thread_local ThreadBindings tb;
+    return tb;
+  }
+
+  Record recs_[max_threads];
+  std::mutex orphan_mu_;
+  std::vector<Retired> orphans_;
+  std::uint64_t id_;
+
+  Record& local() {
+    auto& v = bindings().v;
+    for (auto& b : v) if (b.id == id_) return *b.rec;
+
+    Record* rec = nullptr;
+    for (auto& r : recs_) {
+      bool expected = false;
+      if (!r.active.load(std::memory_order_relaxed) && r.active.compare_exchange_strong(expected, true)) {
+        rec = &r;
+        break;
+      }
+    }
+    if (!rec) throw std::runtime_error("HazardDomain: too many threads");
+    {
+      std::lock_guard lk(registry().m);
+      std::erase_if(v, [](const Binding& b) { return !registry().live.contains(b.id); });
+    }
+    v.push_back({this, id_, rec});
+    return *rec;
+  }
+
+  // Called on thread exit while the domain is still alive.
+  void release(Record& rec) {
+    for (auto& h : rec.hp) h.store(nullptr);
+    scan(rec.retired);
+    if (!rec.retired.empty()) {
+      std::lock_guard lk(orphan_mu_);
+      orphans_.insert(orphans_.end(), rec.retired.begin(), rec.retired.end());
+      rec.retired.clear();
+    }
+    rec.active.store(false);
+  }
+
+  void scan(std::vector<Retired>& list) {
+    std::vector<void*> live;
+    live.reserve(max_threads * slots);
+    for (auto& r : recs_) {
+      if (!r.active.load()) continue;
+      for (auto& h : r.hp) if (void* p = h.load()) live.push_back(p);
+    }
+    std::sort(live.begin(), live.end());
+
+    auto keep = [&](const Retired& x) { return std::binary_search(live.begin(), live.end(), x.p); };
+    auto mid = std::partition(list.begin(), list.end(), keep);
+    for (auto it = mid; it != list.end(); ++it) it->deleter(it->p);
+    list.erase(mid, list.end());
+
+    std::unique_lock lk(orphan_mu_, std::try_to_lock);
+    if (lk.owns_lock() && !orphans_.empty()) {
+      auto omid = std::partition(orphans_.begin(), orphans_.end(), keep);
+      for (auto it = omid; it != orphans_.end(); ++it) it->deleter(it->p);
+      orphans_.erase(omid, orphans_.end());
+    }
+  }
+
+public:
+  HazardDomain() {
+    std::lock_guard lk(registry().m);
+    id_ = registry().next_id++;
+    registry().live.insert(id_);
+  }
+  HazardDomain(const HazardDomain&) = delete;
+  HazardDomain& operator=(const HazardDomain&) = delete;
+  // No thread may be inside protect/retire; threads still bound to this domain forget it.
+  ~HazardDomain() {
+    {
+      std::lock_guard lk(registry().m);
+      registry().live.erase(id_);
+    }
+    for (auto& r : recs_)
+      for (auto& x : r.retired) x.deleter(x.p);
+    for (auto& x : orphans_) x.deleter(x.p);
+  }
+
+  template <class P>
+  P* protect(std::size_t slot, const std::atomic<P*>& src) {
+    auto& h = local().hp[slot];
+    P* p = src.load();
+    for (;;) {
+      h.store(p);
+      P* q = src.load();
+      if (p == q) return p;
+      p = q;
+    }
+  }
+
+  void clear() noexcept {
+    for (auto& h : local().hp) h.store(nullptr);
+  }
+
+  template <class P>
+  void retire(P* p) {
+    auto& rec = local();
+    rec.retired.push_back({p, [](void* q) { delete static_cast<P*>(q); }});
+    if (rec.retired.size() >= 2 * max_threads * slots) scan(rec.retired);
+  }
+};
+
+inline HazardDomain& default_hazard_domain() {
+  static HazardDomain d;
+  return d;
+}
+
+template <class T> requires std::movable<T>
+class ConcurrentQueue {
+  struct Node {
+    std::optional<T> value;
+    std::atomic<Node*> next{nullptr};
+    Node() = default;
+    explicit Node(T v) : value(std::move(v)) {}
+  };
+
+  alignas(64) std::atomic<Node*> head_;
+  alignas(64) std::atomic<Node*> tail_;
+  HazardDomain& hd_;
+
+public:
+  ConcurrentQueue() : ConcurrentQueue(default_hazard_domain()) {}
+  explicit ConcurrentQueue(HazardDomain& hd) : hd_(hd) {
+    Node* dummy = new Node();
+    head_.store(dummy);
+    tail_.store(dummy);
+  }
+
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_value_t<R>, T>
+  explicit ConcurrentQueue(R&& r) : ConcurrentQueue() {
+    for (auto&& x : r) enqueue(static_cast<T>(x));
+  }
+
+  ConcurrentQueue(const ConcurrentQueue&) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+  ~ConcurrentQueue() {
+    Node* n = head_.load(std::memory_order_relaxed);
+    while (n) {
+      Node* next = n->next.load(std::memory_order_relaxed);
+      delete n;
+      n = next;
+    }
+  }
+
+  void enqueue(T value) {
+    // Owned until linked: protect() throws if the hazard domain has no record left for this thread.
+    auto owned = std::make_unique<Node>(std::move(value));
+    Node* n = owned.get();
+    for (;;) {
+      Node* tail = hd_.protect(0, tail_);
+      Node* next = tail->next.load();
+      if (tail != tail_.load()) continue;
+      if (next) {
+        tail_.compare_exchange_weak(tail, next);
+        continue;
+      }
+      Node* expected = nullptr;
+      if (tail->next.compare_exchange_weak(expected, n)) {
+        owned.release();
+        tail_.compare_exchange_strong(tail, n);
+        break;
+      }
+    }
+    hd_.clear();
+  }
+
+  bool dequeue(T& out) {
+    for (;;) {
+      Node* head = hd_.protect(0, head_);
+      Node* tail = tail_.load();
+      Node* next = hd_.protect(1, head->next);
+      if (head != head_.load()) continue;
+      if (!next) {
+        hd_.clear();
+        return false;
+      }
+      if (head == tail) {
+        tail_.compare_exchange_weak(tail, next);
+        continue;
+      }
+      if (head_.compare_exchange_weak(head, next)) {
+        out = std::move(*next->value);
+        next->value.reset();
+        hd_.clear();
+        hd_.retire(head);
+        return true;
+      }
+    }
+  }
+
+  bool empty() {
+    Node* head = hd_.protect(0, head_);
+    bool e = head->next.load() == nullptr;
+    hd_.clear();
+    return e;
+  }
+};
+
+template <class T> requires std::movable<T>
+class SpscRingQueue {
+  static constexpr std::size_t cache_line = 64;
+
+  std::size_t mask_;
+  T* buf_;
+
+  alignas(cache_line) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;
+  alignas(cache_line) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;
+  alignas(cache_line) std::byte pad_[1]{};
+
+  std::size_t free_slots(std::size_t t, std::size_t want) {
+    std::size_t cap = mask_ + 1;
+    if (cap - (t - head_cache_) < want) head_cache_ = head_.load(std::memory_order_acquire);
+    return cap - (t - head_cache_);
+  }
+
+  std::size_t ready_slots(std::size_t h, std::size_t want) {
+    if (tail_cache_ - h < want) tail_cache_ = tail_.load(std::memory_order_acquire);
+    return tail_cache_ - h;
+  }
+
+public:
+  explicit SpscRingQueue(std::size_t capacity)
+    : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+      buf_(static_cast<T*>(::operator new((mask_ + 1) * sizeof(T), std::align_val_t{std::max(alignof(T), cache_line)}))) {}
+
+  SpscRingQueue(const SpscRingQueue&) = delete;
+  SpscRingQueue& operator=(const SpscRingQueue&) = delete;
+
+  ~SpscRingQueue() {
+    for (std::size_t h = head_.load(), t = tail_.load(); h != t; ++h) buf_[h & mask_].~T();
+    ::operator delete(buf_, std::align_val_t{std::max(alignof(T), cache_line)});
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+  // Approximate from a third thread. head is loaded first so tail can only have moved ahead of
+  // it, never wrapping the difference; progress between the two loads can still overshoot.
+  [[nodiscard]] std::size_t size() const noexcept {
+    const std::size_t h = head_.load(std::memory_order_acquire);
+    const std::size_t t = tail_.load(std::memory_order_acquire);
+    return std::min(t - h, capacity());
+  }
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  template <class... Args>
+  bool try_emplace(Args&&... args) {
+    const std::size_t t = tail_.load(std::memory_order_relaxed);
+    if (free_slots(t, 1) == 0) return false;
+    ::new (static_cast<void*>(buf_ + (t & mask_))) T(std::forward<Args>(args)...);
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool enqueue(T value) { return try_emplace(std::move(value)); }
+
+  bool dequeue(T& out) {
+    const std::size_t h = head_.load(std::memory_order_relaxed);
+    if (ready_slots(h, 1) == 0) return false;
+    T& slot = buf_[h & mask_];
+    out = std::move(slot);
+    slot.~T();
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  T& front() {
+    const std::size_t h = head_.load(std::memory_order_relaxed);
+    if (ready_slots(h, 1) == 0) throw std::runtime_error("front() on empty queue");
+    return buf_[h & mask_];
+  }
+
+  template <std::input_iterator It>
+  std::size_t enqueue_bulk(It first, std::size_t n) {
+    const std::size_t t = tail_.load(std::memory_order_relaxed);
+    n = std::min(n, free_slots(t, n));
+    for (std::size_t i = 0; i < n; ++i, ++first)
+      ::new (static_cast<void*>(buf_ + ((t + i) & mask_))) T(std::move(*first));
+    tail_.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  template <std::output_iterator<T&&> Out>
+  std::size_t dequeue_bulk(Out out, std::size_t n) {
+    const std::size_t h = head_.load(std::memory_order_relaxed);
+    n = std::min(n, ready_slots(h, n));
+    for (std::size_t i = 0; i < n; ++i, ++out) {
+      T& slot = buf_[(h + i) & mask_];
+      *out = std::move(slot);
+      slot.~T();
+    }
+    head_.store(h + n, std::memory_order_release);
+    return n;
+  }
+};
+
+} // namespace lockfree
@@ -0,0 +1,172 @@
+#include "lockfree_queue.h"
+#include "list.h"
+
+// Usage: queue_bench --stress [threads] [items]
+//        queue_bench --bench [max_threads] [items]
+// --bench also compares SpscRingQueue with the mutex queue for one producer and one consumer.
+// --stress exits non-zero on a lost, duplicated or reordered item.
+
+using Clock = std::chrono::steady_clock;
+
+// Baseline: the single-threaded LinkedQueue behind one mutex.
+template <class T>
+class MutexQueue {
+  std::mutex m_;
+  LinkedQueue<T> q_;
+
+public:
+  void enqueue(T v) {
+    std::lock_guard lk(m_);
+    q_.enqueue(std::move(v));
+  }
+  bool dequeue(T& out) {
+    std::lock_guard lk(m_);
+    return q_.dequeue(out);
+  }
+};
+
+// Items are producer << 40 | sequence, so consumers can check per-producer FIFO order.
+constexpr int seq_bits = 40;
+
+// `producers` threads push `items` each while `consumers` threads drain; returns seconds.
+// Every consumer checks that each producer's items arrive in increasing order and marks
+// them in `seen`; a slot marked twice or left unmarked is an error.
+template <class Q>
+double run_mpmc(Q& q, unsigned producers, unsigned consumers, std::uint64_t items,
+                std::vector<std::atomic<std::uint8_t>>* seen, std::atomic<std::uint64_t>& errors) {
+  std::atomic<std::uint64_t> consumed{0};
+  const std::uint64_t total = producers * items;
+  std::atomic<bool> go{false};
+  auto t0 = Clock::now();
+  {
+    std::vector<std::jthread> pool;
+    for (unsigned p = 0; p < producers; ++p)
+      pool.emplace_back([&, p] {
+        while (!go.load(std::memory_order_acquire)) {}
+        for (std::uint64_t i = 0; i < items; ++i) q.enqueue(std::uint64_t{p} << seq_bits | i);
+      });
+    for (unsigned c = 0; c < consumers; ++c)
+      pool.emplace_back([&] {
+        while (!go.load(std::memory_order_acquire)) {}
+        std::vector<std::int64_t> last(producers, -1);
+        std::uint64_t v;
+        while (consumed.load(std::memory_order_relaxed) < total) {
+          if (!q.dequeue(v)) continue;
+          consumed.fetch_add(1, std::memory_order_relaxed);
+          const std::uint64_t p = v >> seq_bits, i = v & ((std::uint64_t{1} << seq_bits) - 1);
+          if (p >= producers || i >= items || static_cast<std::int64_t>(i) <= last[p]) {
+            errors.fetch_add(1);
+            continue;
+          }
+          last[p] = static_cast<std::int64_t>(i);
+          if (seen && (*seen)[p * items + i].fetch_add(1) != 0) errors.fetch_add(1);
+        }
+      });
+    t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+  }
+  std::chrono::duration<double> dt = Clock::now() - t0;
+  if (seen)
+    for (auto& s : *seen) if (s.load() != 1) errors.fetch_add(1);
+  return dt.count();
+}
+
+int stress(unsigned threads, std::uint64_t items) {
+  std::atomic<std::uint64_t> errors{0};
+  for (unsigned p = 1; p <= threads; p *= 2) {
+    const unsigned c = std::max(1u, threads - p);
+    std::vector<std::atomic<std::uint8_t>> seen(p * items);
+    {
+      lockfree::ConcurrentQueue<std::uint64_t> q;
+      run_mpmc(q, p, c, items, &seen, errors);
+      std::uint64_t v;
+      if (q.dequeue(v)) errors.fetch_add(1);
+    }
+    std::printf("%u producers, %u consumers: %" PRIu64 " errors so far\n", p, c, errors.load());
+  }
+
+  // Two domains used by the same threads must not share hazard slots or retired lists.
+  {
+    lockfree::HazardDomain d1, d2;
+    lockfree::ConcurrentQueue<std::uint64_t> q1(d1), q2(d2);
+    std::vector<std::atomic<std::uint8_t>> seen(2 * items);
+    std::jthread other([&] { run_mpmc(q2, 2, 2, items, nullptr, errors); });
+    run_mpmc(q1, 2, 2, items, &seen, errors);
+  }
+  std::printf("two hazard domains: %" PRIu64 " errors\n", errors.load());
+  std::printf("%s\n", errors ? "stress failed" : "stress passed");
+  return errors ? 1 : 0;
+}
+
+void bench(unsigned max_threads, std::uint64_t items) {
+  std::atomic<std::uint64_t> errors{0};
+  std::printf("threads  lockfree Mops/s  mutex Mops/s\n");
+  for (unsigned t = 1; t <= max_threads; ++t) {
+    // t producers and t consumers, each producer pushing `items`.
+    lockfree::ConcurrentQueue<std::uint64_t> lf;
+    MutexQueue<std::uint64_t> mq;
+    const double a = run_mpmc(lf, t, t, items, nullptr, errors);
+    const double b = run_mpmc(mq, t, t, items, nullptr, errors);
+    std::printf("%7u  %15.2f  %12.2f\n", t, t * items / a * 1e-6, t * items / b * 1e-6);
+  }
+
+  // SPSC: streaming throughput, then ping-pong round trips through a pair of queues.
+  auto throughput = [&](auto& q, auto push) {
+    auto t0 = Clock::now();
+    std::jthread producer([&] {
+      for (std::uint64_t i = 0; i < items; ++i)
+        while (!push(q, i)) std::this_thread::yield();
+    });
+    std::uint64_t v, expect = 0;
+    while (expect < items) {
+      if (!q.dequeue(v)) { std::this_thread::yield(); continue; }
+      if (v != expect++) errors.fetch_add(1);
+    }
+    producer.join();
+    std::chrono::duration<double> dt = Clock::now() - t0;
+    return items / dt.count() * 1e-6;
+  };
+  auto round_trip = [&](auto& ping, auto& pong, auto push) {
+    const std::uint64_t trips = std::min<std::uint64_t>(items, 100'000);
+    std::jthread echo([&] {
+      std::uint64_t v;
+      for (std::uint64_t i = 0; i < trips; ++i) {
+        while (!ping.dequeue(v)) std::this_thread::yield();
+        while (!push(pong, v)) std::this_thread::yield();
+      }
+    });
+    auto t0 = Clock::now();
+    std::uint64_t v;
+    for (std::uint64_t i = 0; i < trips; ++i) {
+      while (!push(ping, i)) std::this_thread::yield();
+      while (!pong.dequeue(v)) std::this_thread::yield();
+      if (v != i) errors.fetch_add(1);
+    }
+    std::chrono::duration<double, std::nano> dt = Clock::now() - t0;
+    return dt.count() / trips;
+  };
+
+  auto spsc_push = [](lockfree::SpscRingQueue<std::uint64_t>& q, std::uint64_t v) { return q.enqueue(v); };
+  auto mutex_push = [](MutexQueue<std::uint64_t>& q, std::uint64_t v) { q.enqueue(v); return true; };
+  lockfree::SpscRingQueue<std::uint64_t> s1(1024), s2(1024), s3(1024);
+  MutexQueue<std::uint64_t> m1, m2, m3;
+  const double spsc_tp = throughput(s1, spsc_push), mutex_tp = throughput(m1, mutex_push);
+  const double spsc_rt = round_trip(s2, s3, spsc_push), mutex_rt = round_trip(m2, m3, mutex_push);
+  std::printf("\n1 producer, 1 consumer  spsc     mutex\n"
+              "throughput Mops/s  %10.2f  %8.2f\n"
+              "round trip ns      %10.0f  %8.0f\n",
+              spsc_tp, mutex_tp, spsc_rt, mutex_rt);
+  if (errors) std::printf("%" PRIu64 " ordering errors\n", errors.load());
+}
+
+int main(int argc, char** argv) {
+  const std::string_view mode = argc > 1 ? argv[1] : "";
+  const unsigned threads = argc > 2 ? std::stoul(argv[2]) : std::max(2u, std::thread::hardware_concurrency());
+  if (mode == "--stress") return stress(threads, argc > 3 ? std::stoull(argv[3]) : 200'000);
+  if (mode == "--bench") {
+    bench(threads, argc > 3 ? std::stoull(argv[3]) : 500'000);
+    return 0;
+  }
+  std::fprintf(stderr, "usage: queue_bench --stress|--bench [threads] [items]\n");
+  return 2;
+}
@@ -1,29 +1,1255 @@
 #include <bits/stdc++.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+
+inline constexpr std::ptrdiff_t insertion_threshold = 24;
+inline constexpr std::ptrdiff_t ninther_threshold = 128;
+
+template <class I, class Comp, class Proj>
+void insertion_sort(I first, I last, Comp& comp, Proj& proj) {
+  if (first == last) return;
+  for (I i = first + 1; i < last; ++i) {
+    std::iter_value_t<I> tmp = std::ranges::iter_move(i);
+    I j = i;
+    for (; j != first && std::invoke(comp, std::invoke(proj, tmp), std::invoke(proj, *(j - 1))); --j)
+      *j = std::ranges::iter_move(j - 1);
+    *j = std::move(tmp);
+  }
+}
+
+template <class I, class Comp, class Proj>
+void sort3(I a, I b, I c, Comp& comp, Proj& proj) {
+  auto less = [&](I x, I y) { return std::invoke(comp, std::invoke(proj, *x), std::invoke(proj, *y)); };
+  if (less(b, a)) std::iter_swap(a, b);
+  if (less(c, b)) {
+    std::iter_swap(b, c);
+    if (less(b, a)) std::iter_swap(a, b);
+  }
+}
+
+// Leaves the chosen pivot at the middle position: median of three, or Tukey's ninther on large ranges.
+template <class I, class Comp, class Proj>
+I choose_pivot(I first, I last, Comp& comp, Proj& proj) {
+  const auto n = last - first;
+  I mid = first + n / 2;
+  if (n > ninther_threshold) {
+    sort3(first, mid, last - 1, comp, proj);
+    sort3(first + 1, mid - 1, last - 2, comp, proj);
+    sort3(first + 2, mid + 1, last - 3, comp, proj);
+    sort3(mid - 1, mid, mid + 1, comp, proj);
+  } else {
+    sort3(first, mid, last - 1, comp, proj);
+  }
+  return mid;
+}
+
+template <class I, class Comp, class Proj>
+void introsort_loop(I first, I last, int depth, Comp& comp, Proj& proj) {
+  while (last - first > insertion_threshold) {
+    if (depth-- == 0) {
+      std::ranges::make_heap(first, last, comp, proj);
+      std::ranges::sort_heap(first, last, comp, proj);
+      return;
+    }
 
-template <std::random_access_iterator I,
-          class Comp = std::ranges::less,
-          class Proj = std::identity>
-requires std::sortable<I, Comp, Proj>
-void quicksort(I first, I last, Comp comp = {}, Proj proj = {}) {
-  while (last - first > 1) {
     I left  = first;
     I right = last - 1;
-    const auto pivot_key = std::invoke(proj, *(first + (last - first) / 2)); 
+    const auto pivot_key = std::invoke(proj, *choose_pivot(first, last, comp, proj));
 
     while (true) {
-      while (left  < last  && comp(std::invoke(proj, *left),  pivot_key)) ++left;
-      while (right >= first && comp(pivot_key, std::invoke(proj, *right))) --right;
+      while (comp(std::invoke(proj, *left),  pivot_key)) ++left;
+      while (comp(pivot_key, std::invoke(proj, *right))) --right;
       if (!(left < right)) break;
       std::iter_swap(left++, right--);
     }
     I mid = right + 1;
 
     if (mid - first < last - mid) {
-      quicksort(first, mid, comp, proj);
+      introsort_loop(first, mid, depth, comp, proj);
+      first = mid;
+    } else {
+      introsort_loop(mid, last, depth, comp, proj);
+      last = mid;
+    }
+  }
+  insertion_sort(first, last, comp, proj);
+}
+
+inline constexpr std::size_t partition_block = 64;
+inline constexpr std::ptrdiff_t partial_insertion_limit = 8;
+
+// Insertion sort that gives up after moving partial_insertion_limit elements.
+template <class I, class Less>
+bool partial_insertion_sort(I first, I last, Less& less) {
+  if (first == last) return true;
+  std::ptrdiff_t moved = 0;
+  for (I i = first + 1; i < last; ++i) {
+    if (!less(*i, *(i - 1))) continue;
+    std::iter_value_t<I> tmp = std::ranges::iter_move(i);
+    I j = i;
+    do { *j = std::ranges::iter_move(j - 1); --j; } while (j != first && less(tmp, *(j - 1)));
+    *j = std::move(tmp);
+    moved += i - j;
+    if (moved > partial_insertion_limit) return false;
+  }
+  return true;
+}
+
+template <class I>
+void swap_offsets(I first, I last, const unsigned char* off_l, const unsigned char* off_r,
+                  std::size_t num, bool use_swaps) {
+  if (use_swaps) {
+    for (std::size_t i = 0; i < num; ++i) std::iter_swap(first + off_l[i], last - off_r[i]);
+  } else if (num > 0) {
+    I l = first + off_l[0], r = last - off_r[0];
+    std::iter_value_t<I> tmp = std::ranges::iter_move(l);
+    *l = std::ranges::iter_move(r);
+    for (std::size_t i = 1; i < num; ++i) {
+      l = first + off_l[i]; *r = std::ranges::iter_move(l);
+      r = last - off_r[i];  *l = std::ranges::iter_move(r);
+    }
+    *r = std::move(tmp);
+  }
+}
+
+// Partitions around *first into [< pivot] pivot [>= pivot]. Comparison results are recorded as
+// offsets for a block at a time and the misplaced elements swapped afterwards, so the scanning
+// loops carry no data-dependent branches. Also reports whether the range was already partitioned.
+template <class I, class Less>
+std::pair<I, bool> partition_right_branchless(I begin, I end, Less& less) {
+  std::iter_value_t<I> pivot = std::ranges::iter_move(begin);
+  I first = begin, last = end;
+
+  while (less(*++first, pivot));
+  if (first - 1 == begin) while (first < last && !less(*--last, pivot));
+  else                    while (!less(*--last, pivot));
+
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    std::iter_swap(first, last);
+    ++first;
+
+    alignas(64) unsigned char offsets_l[partition_block];
+    alignas(64) unsigned char offsets_r[partition_block];
+    I base_l = first, base_r = last;
+    std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+    while (first < last) {
+      const std::size_t unknown = last - first;
+      const std::size_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+      const std::size_t split_r = num_r == 0 ? unknown - split_l : 0;
+
+      const std::size_t nl = std::min(split_l, partition_block);
+      for (std::size_t i = 0; i < nl; ++i) {
+        offsets_l[num_l] = static_cast<unsigned char>(i);
+        num_l += !less(*first, pivot);
+        ++first;
+      }
+      const std::size_t nr = std::min(split_r, partition_block);
+      for (std::size_t i = 0; i < nr; ) {
+        offsets_r[num_r] = static_cast<unsigned char>(++i);
+        num_r += less(*--last, pivot);
+      }
+
+      const std::size_t num = std::min(num_l, num_r);
+      swap_offsets(base_l, base_r, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+      num_l -= num; num_r -= num;
+      start_l += num; start_r += num;
+      if (num_l == 0) { start_l = 0; base_l = first; }
+      if (num_r == 0) { start_r = 0; base_r = last; }
+    }
+
+    if (num_l) {
+      while (num_l--) std::iter_swap(base_l + offsets_l[start_l + num_l], --last);
+      first = last;
+    }
+    if (num_r) {
+      while (num_r--) std::iter_swap(base_r - offsets_r[start_r + num_r], first), ++first;
+      last = first;
+    }
+  }
+
+  I pivot_pos = first - 1;
+  *begin = std::ranges::iter_move(pivot_pos);
+  *pivot_pos = std::move(pivot);
+  return {pivot_pos, already_partitioned};
+}
+
+// Puts everything equal to the pivot *begin on the left; used when the pivot repeats the
+// previous partition's pivot, so the left side needs no further sorting.
+template <class I, class Less>
+I partition_left(I begin, I end, Less& less) {
+  std::iter_value_t<I> pivot = std::ranges::iter_move(begin);
+  I first = begin, last = end;
+
+  while (less(pivot, *--last));
+  if (last + 1 == end) while (first < last && !less(pivot, *++first));
+  else                 while (!less(pivot, *++first));
+
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (less(pivot, *--last));
+    while (!less(pivot, *++first));
+  }
+
+  *begin = std::ranges::iter_move(last);
+  *last = std::move(pivot);
+  return last;
+}
+
+template <class I, class Less>
+void pdq_loop(I begin, I end, Less& less, int bad_allowed, bool leftmost) {
+  std::identity id;
+  while (true) {
+    const auto size = end - begin;
+    if (size <= insertion_threshold) {
+      insertion_sort(begin, end, less, id);
+      return;
+    }
+
+    const auto s2 = size / 2;
+    if (size > ninther_threshold) {
+      sort3(begin, begin + s2, end - 1, less, id);
+      sort3(begin + 1, begin + (s2 - 1), end - 2, less, id);
+      sort3(begin + 2, begin + (s2 + 1), end - 3, less, id);
+      sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less, id);
+      std::iter_swap(begin, begin + s2);
+    } else {
+      sort3(begin + s2, begin, end - 1, less, id);
+    }
+
+    if (!leftmost && !less(*(begin - 1), *begin)) {
+      begin = partition_left(begin, end, less) + 1;
+      continue;
+    }
+
+    auto [pivot_pos, already_partitioned] = partition_right_branchless(begin, end, less);
+    const auto l_size = pivot_pos - begin;
+    const auto r_size = end - (pivot_pos + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        std::ranges::make_heap(begin, end, less);
+        std::ranges::sort_heap(begin, end, less);
+        return;
+      }
+      // Pattern-defeating shuffle: break up whatever structure produced the bad split.
+      if (l_size > insertion_threshold) {
+        std::iter_swap(begin, begin + l_size / 4);
+        std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > ninther_threshold) {
+          std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+          std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+          std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+          std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if (r_size > insertion_threshold) {
+        std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        std::iter_swap(end - 1, end - r_size / 4);
+        if (r_size > ninther_threshold) {
+          std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+          std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+          std::iter_swap(end - 2, end - (1 + r_size / 4));
+          std::iter_swap(end - 3, end - (2 + r_size / 4));
+        }
+      }
+    } else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, less) &&
+               partial_insertion_sort(pivot_pos + 1, end, less)) {
+      return;
+    }
+
+    pdq_loop(begin, pivot_pos, less, bad_allowed, leftmost);
+    begin = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+template <class I>
+int depth_limit(I first, I last) {
+  return std::bit_width(static_cast<std::make_unsigned_t<std::iter_difference_t<I>>>(last - first)) - 1;
+}
+
+template <class Comp, class K>
+inline constexpr bool is_less_v =
+  std::same_as<Comp, std::ranges::less> || std::same_as<Comp, std::less<>> || std::same_as<Comp, std::less<K>>;
+
+template <class Comp, class K>
+inline constexpr bool is_greater_v =
+  std::same_as<Comp, std::ranges::greater> || std::same_as<Comp, std::greater<>> || std::same_as<Comp, std::greater<K>>;
+
+template <class T>
+concept SimdKey = (std::signed_integral<T> || (std::floating_point<T> && std::numeric_limits<T>::is_iec559)) &&
+                  (sizeof(T) == 4 || sizeof(T) == 8);
+
+#if defined(__x86_64__)
+// The kernels below are target-neutral templates over a vector traits class V. Only the traits'
+// ops carry a target attribute; the kernels are always_inline into each ISA's quicksort entry, so
+// every call that passes a vector register is made from code compiled for that ISA (which is why
+// the -Wpsabi warnings about the neutral templates are silenced).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+inline constexpr int simd_leaf = 64;
+
+template <class T>
+inline constexpr T simd_fill = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                   : std::numeric_limits<T>::max();
+
+constexpr unsigned bitonic_hi_lanes(int w, int j, int k) {
+  unsigned m = 0;
+  for (int l = 0; l < w; ++l)
+    if (((l & j) != 0) != (k < w && (l & k) != 0)) m |= 1u << l;
+  return m;
+}
+
+// One compare-exchange step (block size K, distance J) of a bitonic network over N / W registers.
+template <class V, int N, int K, int J>
+[[gnu::always_inline]] inline void bitonic_step(typename V::reg* r) {
+  constexpr int W = V::W, R = N / W;
+  if constexpr (J >= W) {
+    constexpr int d = J / W;
+    for (int i = 0; i < R; ++i) {
+      if (i & d) continue;
+      auto lo = V::min(r[i], r[i + d]), hi = V::max(r[i], r[i + d]);
+      const bool up = (i * W & K) == 0;
+      r[i] = up ? lo : hi;
+      r[i + d] = up ? hi : lo;
+    }
+  } else {
+    constexpr unsigned up = bitonic_hi_lanes(W, J, K), down = up ^ ((1u << W) - 1);
+    for (int i = 0; i < R; ++i) {
+      auto p = V::template swap<J>(r[i]);
+      auto lo = V::min(r[i], p), hi = V::max(r[i], p);
+      r[i] = (i * W & K) ? V::template blend<down>(lo, hi) : V::template blend<up>(lo, hi);
+    }
+  }
+}
+
+template <class V, int N, int K, int J>
+[[gnu::always_inline]] inline void bitonic_stage(typename V::reg* r) {
+  bitonic_step<V, N, K, J>(r);
+  if constexpr (J > 1) bitonic_stage<V, N, K, J / 2>(r);
+}
+
+template <class V, int N, int K = 2>
+[[gnu::always_inline]] inline void bitonic_network(typename V::reg* r) {
+  bitonic_stage<V, N, K, K / 2>(r);
+  if constexpr (K < N) bitonic_network<V, N, 2 * K>(r);
+}
+
+// Sorts n <= N elements in registers; the missing lanes are padded with the largest key.
+// Registers wholly past the end never form a pointer beyond p + n.
+template <class V, int N, class T>
+[[gnu::always_inline]] inline void sort_block(T* p, int n) {
+  constexpr int W = V::W, R = N / W;
+  typename V::reg r[R];
+  for (int i = 0; i < R; ++i)
+    r[i] = i * W < n ? V::load(p + i * W, std::min(n - i * W, W)) : V::set1(simd_fill<T>);
+  bitonic_network<V, N>(r);
+  for (int i = 0; i * W < n; ++i) V::store(p + i * W, r[i], std::min(n - i * W, W));
+}
+
+template <class V, class T, int N = std::max(V::W, 8)>
+[[gnu::always_inline]] inline void sort_leaf(T* p, int n) {
+  if constexpr (N < simd_leaf) {
+    if (n > N) return sort_leaf<V, T, 2 * N>(p, n);
+  }
+  sort_block<V, N>(p, n);
+}
+
+template <class V, bool OrEqual, class T>
+[[gnu::always_inline]] inline void partition_store(T*& wl, T*& wr, const typename V::reg& v,
+                                                   const typename V::reg& pv, unsigned valid) {
+  const unsigned m = (OrEqual ? V::less(pv, v) ^ ((1u << V::W) - 1) : V::less(v, pv)) & valid;
+  V::compress(wl, v, m);
+  wl += std::popcount(m);
+  wr -= std::popcount(valid & ~m);
+  V::compress(wr, v, valid & ~m);
+}
+
+// In-place vector partition: one register from each end is buffered so the side with less free
+// space is always read next, and every register is compress-stored to both write fronts.
+// Left side gets x < pivot (or x <= pivot when OrEqual). Needs last - first >= 2 * W.
+template <class V, bool OrEqual, class T>
+[[gnu::always_inline]] inline T* simd_partition(T* first, T* last, T pivot) {
+  using reg = typename V::reg;
+  constexpr int W = V::W;
+  constexpr unsigned all = (1u << W) - 1;
+  const reg pv = V::set1(pivot);
+
+  const int tail = static_cast<int>((last - first) % W);
+  T* wl = first;
+  T* wr = last;
+  const reg vt = V::load(first, tail);
+  T* l = first + tail;
+  T* r = last - W;
+  const reg vl = V::loadu(l), vr = V::loadu(r);
+  l += W;
+
+  while (l != r) {
+    if (l - wl <= wr - r) {
+      partition_store<V, OrEqual>(wl, wr, V::loadu(l), pv, all);
+      l += W;
+    } else {
+      r -= W;
+      partition_store<V, OrEqual>(wl, wr, V::loadu(r), pv, all);
+    }
+  }
+  partition_store<V, OrEqual>(wl, wr, vl, pv, all);
+  partition_store<V, OrEqual>(wl, wr, vr, pv, all);
+  partition_store<V, OrEqual>(wl, wr, vt, pv, (1u << tail) - 1);
+  return wl;
+}
+
+template <class V, class T>
+[[gnu::always_inline]] inline void simd_quicksort_loop(T* first, T* last, int depth) {
+  std::ranges::less less;
+  std::identity id;
+  while (last - first > simd_leaf) {
+    if (depth-- == 0) {
+      std::ranges::make_heap(first, last);
+      std::ranges::sort_heap(first, last);
+      return;
+    }
+    const T pivot = *choose_pivot(first, last, less, id);
+    T* mid = simd_partition<V, false>(first, last, pivot);
+    if (mid == first) {
+      // The pivot is the minimum: its copies are already in their final place.
+      first = simd_partition<V, true>(first, last, pivot);
+      continue;
+    }
+    if (mid - first < last - mid) {
+      V::quicksort(first, mid, depth);
+      first = mid;
+    } else {
+      V::quicksort(mid, last, depth);
+      last = mid;
+    }
+  }
+  sort_leaf<V>(first, static_cast<int>(last - first));
+}
+
+// GCC 12 reports a false -Wmaybe-uninitialized for the placeholder '__Y' that avx512fintrin.h's
+// _mm512_undefined_* helpers initialize from itself, once the shuffles are inlined into quicksort.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+template <SimdKey T>
+struct Avx512 {
+  using reg = __m512i;
+  static constexpr int W = 64 / sizeof(T);
+
+  [[gnu::target("avx512f")]] static reg set1(T x) {
+    if constexpr (sizeof(T) == 4) return _mm512_set1_epi32(std::bit_cast<std::int32_t>(x));
+    else return _mm512_set1_epi64(std::bit_cast<std::int64_t>(x));
+  }
+  [[gnu::target("avx512f")]] static reg loadu(const T* p) { return _mm512_loadu_si512(p); }
+  [[gnu::target("avx512f")]] static reg load(const T* p, int n) {
+    if constexpr (sizeof(T) == 4) return _mm512_mask_loadu_epi32(set1(simd_fill<T>), (1u << n) - 1, p);
+    else return _mm512_mask_loadu_epi64(set1(simd_fill<T>), (1u << n) - 1, p);
+  }
+  [[gnu::target("avx512f")]] static void store(T* p, reg v, int n) {
+    if constexpr (sizeof(T) == 4) _mm512_mask_storeu_epi32(p, (1u << n) - 1, v);
+    else _mm512_mask_storeu_epi64(p, (1u << n) - 1, v);
+  }
+  [[gnu::target("avx512f")]] static void compress(T* p, reg v, unsigned m) {
+    const unsigned n = (1u << std::popcount(m)) - 1;
+    if constexpr (sizeof(T) == 4) _mm512_mask_storeu_epi32(p, n, _mm512_maskz_compress_epi32(m, v));
+    else _mm512_mask_storeu_epi64(p, n, _mm512_maskz_compress_epi64(m, v));
+  }
+
+  [[gnu::target("avx512f")]] static reg min(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm512_castps_si512(_mm512_min_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b)));
+    else if constexpr (std::same_as<T, double>) return _mm512_castpd_si512(_mm512_min_pd(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b)));
+    else if constexpr (sizeof(T) == 4) return _mm512_min_epi32(a, b);
+    else return _mm512_min_epi64(a, b);
+  }
+  [[gnu::target("avx512f")]] static reg max(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm512_castps_si512(_mm512_max_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b)));
+    else if constexpr (std::same_as<T, double>) return _mm512_castpd_si512(_mm512_max_pd(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b)));
+    else if constexpr (sizeof(T) == 4) return _mm512_max_epi32(a, b);
+    else return _mm512_max_epi64(a, b);
+  }
+  [[gnu::target("avx512f")]] static unsigned less(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_LT_OQ);
+    else if constexpr (std::same_as<T, double>) return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_LT_OQ);
+    else if constexpr (sizeof(T) == 4) return _mm512_cmplt_epi32_mask(a, b);
+    else return _mm512_cmplt_epi64_mask(a, b);
+  }
+
+  // Lane l trades with lane l ^ J.
+  template <int J>
+  [[gnu::target("avx512f")]] static reg swap(reg v) {
+    constexpr int bytes = J * sizeof(T);
+    if constexpr (bytes == 4) return _mm512_shuffle_epi32(v, _MM_PERM_CDAB);
+    else if constexpr (bytes == 8) return _mm512_shuffle_epi32(v, _MM_PERM_BADC);
+    else if constexpr (bytes == 16) return _mm512_shuffle_i64x2(v, v, 0b10110001);
+    else return _mm512_shuffle_i64x2(v, v, 0b01001110);
+  }
+  template <unsigned M>
+  [[gnu::target("avx512f")]] static reg blend(reg a, reg b) {
+    if constexpr (sizeof(T) == 4) return _mm512_mask_blend_epi32(M, a, b);
+    else return _mm512_mask_blend_epi64(M, a, b);
+  }
+
+  [[gnu::target("avx512f"), gnu::flatten]] static void quicksort(T* first, T* last, int depth) {
+    simd_quicksort_loop<Avx512>(first, last, depth);
+  }
+};
+#pragma GCC diagnostic pop
+
+template <SimdKey T>
+struct Avx2 {
+  using reg = __m256i;
+  static constexpr int W = 32 / sizeof(T);
+
+  // permutevar8x32 indices that move the lanes selected by each mask to the front.
+  static constexpr auto compress_lut = [] {
+    constexpr int s = 8 / W;
+    std::array<std::array<std::int32_t, 8>, (1u << W)> t{};
+    for (unsigned m = 0; m < (1u << W); ++m) {
+      int k = 0;
+      for (int l = 0; l < W; ++l)
+        if (m >> l & 1) for (int i = 0; i < s; ++i) t[m][k++] = l * s + i;
+    }
+    return t;
+  }();
+
+  [[gnu::target("avx2")]] static reg set1(T x) {
+    if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(std::bit_cast<std::int32_t>(x));
+    else return _mm256_set1_epi64x(std::bit_cast<std::int64_t>(x));
+  }
+  [[gnu::target("avx2")]] static reg first_lanes(int n) {
+    if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    else return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), _mm256_setr_epi64x(0, 1, 2, 3));
+  }
+  [[gnu::target("avx2")]] static reg loadu(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  [[gnu::target("avx2")]] static reg load(const T* p, int n) {
+    const reg m = first_lanes(n);
+    reg v;
+    if constexpr (sizeof(T) == 4) v = _mm256_maskload_epi32(reinterpret_cast<const int*>(p), m);
+    else v = _mm256_maskload_epi64(reinterpret_cast<const long long*>(p), m);
+    return _mm256_blendv_epi8(set1(simd_fill<T>), v, m);
+  }
+  [[gnu::target("avx2")]] static void store(T* p, reg v, int n) {
+    if constexpr (sizeof(T) == 4) _mm256_maskstore_epi32(reinterpret_cast<int*>(p), first_lanes(n), v);
+    else _mm256_maskstore_epi64(reinterpret_cast<long long*>(p), first_lanes(n), v);
+  }
+  [[gnu::target("avx2")]] static void compress(T* p, reg v, unsigned m) {
+    const reg idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress_lut[m].data()));
+    store(p, _mm256_permutevar8x32_epi32(v, idx), std::popcount(m));
+  }
+
+  [[gnu::target("avx2")]] static reg min(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    else if constexpr (std::same_as<T, double>) return _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    else if constexpr (sizeof(T) == 4) return _mm256_min_epi32(a, b);
+    else return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+  }
+  [[gnu::target("avx2")]] static reg max(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    else if constexpr (std::same_as<T, double>) return _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    else if constexpr (sizeof(T) == 4) return _mm256_max_epi32(a, b);
+    else return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+  }
+  [[gnu::target("avx2")]] static unsigned less(reg a, reg b) {
+    if constexpr (std::same_as<T, float>) return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ));
+    else if constexpr (std::same_as<T, double>) return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ));
+    else if constexpr (sizeof(T) == 4) return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)));
+    else return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a)));
+  }
+
+  template <int J>
+  [[gnu::target("avx2")]] static reg swap(reg v) {
+    constexpr int bytes = J * sizeof(T);
+    if constexpr (bytes == 4) return _mm256_shuffle_epi32(v, 0b10110001);
+    else if constexpr (bytes == 8) return _mm256_shuffle_epi32(v, 0b01001110);
+    else return _mm256_permute2x128_si256(v, v, 1);
+  }
+  template <unsigned M>
+  [[gnu::target("avx2")]] static reg blend(reg a, reg b) {
+    if constexpr (sizeof(T) == 4) return _mm256_blend_epi32(a, b, M);
+    else return _mm256_blend_epi32(a, b, (M & 1) * 0x03 | (M & 2) * 0x06 | (M & 4) * 0x0c | (M & 8) * 0x18);
+  }
+
+  [[gnu::target("avx2"), gnu::flatten]] static void quicksort(T* first, T* last, int depth) {
+    simd_quicksort_loop<Avx2>(first, last, depth);
+  }
+};
+
+#pragma GCC diagnostic pop
+
+// Picks the widest kernel the CPU supports; false means the caller has to sort. Four 64-bit lanes
+// are too narrow for AVX2 to beat the scalar block partition, so 8-byte keys need AVX-512.
+template <SimdKey T>
+bool simd_sort(T* first, T* last) {
+  const int depth = 2 * depth_limit(first, last);
+  if (__builtin_cpu_supports("avx512f")) Avx512<T>::quicksort(first, last, depth);
+  else if (sizeof(T) == 4 && __builtin_cpu_supports("avx2")) Avx2<T>::quicksort(first, last, depth);
+  else return false;
+  return true;
+}
+#endif
+
+} // namespace detail
+
+struct HoarePartition {
+  template <class I, class Comp, class Proj>
+  static void sort(I first, I last, Comp& comp, Proj& proj) {
+    detail::introsort_loop(first, last, 2 * detail::depth_limit(first, last), comp, proj);
+  }
+};
+
+struct BlockPartition {
+  template <class I, class Comp, class Proj>
+  static void sort(I first, I last, Comp& comp, Proj& proj) {
+    auto less = [&](auto&& a, auto&& b) { return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b)); };
+    detail::pdq_loop(first, last, less, detail::depth_limit(first, last), true);
+  }
+};
+
+// Vectorized quicksort (compress-store partition, bitonic networks on leaves of up to 64) for
+// int32/int64/float/double with no projection; anything else, or no AVX2, uses BlockPartition.
+struct SimdPartition {
+  template <class I, class Comp, class Proj>
+  static void sort(I first, I last, Comp& comp, Proj& proj) {
+#if defined(__x86_64__)
+    using T = std::iter_value_t<I>;
+    if constexpr (std::contiguous_iterator<I> && detail::SimdKey<T> && std::same_as<Proj, std::identity> &&
+                  (detail::is_less_v<Comp, T> || detail::is_greater_v<Comp, T>)) {
+      if (detail::simd_sort(std::to_address(first), std::to_address(last))) {
+        if constexpr (detail::is_greater_v<Comp, T>) std::reverse(first, last);
+        return;
+      }
+    }
+#endif
+    BlockPartition::sort(first, last, comp, proj);
+  }
+};
+
+template <class P>
+concept PartitionPolicy =
+  std::same_as<P, HoarePartition> || std::same_as<P, BlockPartition> || std::same_as<P, SimdPartition>;
+
+template <PartitionPolicy Policy = HoarePartition,
+          std::random_access_iterator I,
+          class Comp = std::ranges::less,
+          class Proj = std::identity>
+requires std::sortable<I, Comp, Proj>
+void quicksort(I first, I last, Comp comp = {}, Proj proj = {}) {
+  if (last - first < 2) return;
+  Policy::sort(first, last, comp, proj);
+}
+
+class WorkStealingPool {
+public:
+  class Group {
+    friend class WorkStealingPool;
+    std::atomic<std::size_t> pending_{0};
+    std::mutex m_;
+    std::exception_ptr error_;
+  };
+
+private:
+  struct Task {
+    std::function<void()> fn;
+    Group* group;
+  };
+
+  struct Queue {
+    std::mutex m;
+    std::deque<Task> d;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::jthread> workers_;
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<unsigned> next_{0};
+  std::mutex sleep_m_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+
+  static inline thread_local const WorkStealingPool* owner_ = nullptr;
+  static inline thread_local unsigned self_ = 0;
+
+  bool is_worker() const noexcept { return owner_ == this; }
+
+  // Owners pop their own queue LIFO; thieves take the oldest task from someone else's.
+  bool try_run_one() {
+    const unsigned n = queues_.size();
+    const unsigned start = is_worker() ? self_ : next_.fetch_add(1, std::memory_order_relaxed) % n;
+    std::optional<Task> task;
+    for (unsigned k = 0; k < n && !task; ++k) {
+      Queue& q = *queues_[(start + k) % n];
+      std::lock_guard lk(q.m);
+      if (q.d.empty()) continue;
+      if (k == 0 && is_worker()) task = std::move(q.d.back()), q.d.pop_back();
+      else task = std::move(q.d.front()), q.d.pop_front();
+    }
+    if (!task) return false;
+    queued_.fetch_sub(1);
+
+    try {
+      task->fn();
+    } catch (...) {
+      std::lock_guard lk(task->group->m_);
+      if (!task->group->error_) task->group->error_ = std::current_exception();
+    }
+    task->group->pending_.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+
+  void worker_loop(unsigned i) {
+    owner_ = this;
+    self_ = i;
+    for (;;) {
+      if (try_run_one()) continue;
+      std::unique_lock lk(sleep_m_);
+      cv_.wait(lk, [&] { return stop_ || queued_.load() > 0; });
+      if (stop_ && queued_.load() == 0) return;
+    }
+  }
+
+public:
+  explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+    threads = std::max(1u, threads);
+    for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { worker_loop(i); });
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard lk(sleep_m_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    // Join before cv_, sleep_m_ and the counters (declared after workers_) are destroyed.
+    workers_.clear();
+  }
+
+  [[nodiscard]] unsigned size() const noexcept { return queues_.size(); }
+
+  template <class F>
+  void spawn(Group& g, F&& f) {
+    g.pending_.fetch_add(1, std::memory_order_relaxed);
+    const unsigned i = is_worker() ? self_ : next_.fetch_add(1, std::memory_order_relaxed) % size();
+    {
+      std::lock_guard lk(queues_[i]->m);
+      queues_[i]->d.push_back({std::forward<F>(f), &g});
+    }
+    {
+      std::lock_guard lk(sleep_m_);
+      queued_.fetch_add(1);
+    }
+    cv_.notify_one();
+  }
+
+  // Runs queued tasks on the calling thread until every task spawned into g has finished.
+  void wait(Group& g) {
+    while (g.pending_.load(std::memory_order_acquire) > 0) {
+      if (!try_run_one()) std::this_thread::yield();
+    }
+    std::lock_guard lk(g.m_);
+    if (g.error_) std::rethrow_exception(std::exchange(g.error_, nullptr));
+  }
+};
+
+namespace detail {
+
+inline constexpr std::ptrdiff_t parallel_grain = 1 << 14;
+inline constexpr std::ptrdiff_t parallel_partition_threshold = 1 << 20;
+
+// In-place block partition: each block is partitioned on its own, then the elements on the
+// wrong side of the global split point are swapped across in parallel. Returns the split point.
+template <class I, class Pred>
+I parallel_partition(I first, I last, Pred pred, WorkStealingPool& pool) {
+  using D = std::iter_difference_t<I>;
+  const D n = last - first;
+  const D blocks = std::min<D>(pool.size() * 4, n / parallel_grain);
+  const D bs = (n + blocks - 1) / blocks;
+
+  std::vector<D> split(blocks);
+  {
+    WorkStealingPool::Group g;
+    for (D b = 0; b < blocks; ++b) {
+      pool.spawn(g, [=, &split] {
+        I lo = first + b * bs, hi = first + std::min(n, (b + 1) * bs);
+        split[b] = std::partition(lo, hi, pred) - first;
+      });
+    }
+    pool.wait(g);
+  }
+
+  D total = 0;
+  for (D b = 0; b < blocks; ++b) total += split[b] - b * bs;
+
+  // Misplaced runs: [split, block end) inside [0, total) and [block begin, split) inside [total, n).
+  std::vector<std::pair<D, D>> high, low;
+  for (D b = 0; b < blocks; ++b) {
+    const D lo = b * bs, hi = std::min(n, (b + 1) * bs), s = split[b];
+    if (std::max(s, lo) < std::min(hi, total)) high.emplace_back(std::max(s, lo), std::min(hi, total));
+    if (std::max(lo, total) < std::min(s, hi)) low.emplace_back(std::max(lo, total), std::min(s, hi));
+  }
+  auto prefix = [](const std::vector<std::pair<D, D>>& runs) {
+    std::vector<D> p(runs.size() + 1, 0);
+    for (std::size_t i = 0; i < runs.size(); ++i) p[i + 1] = p[i] + (runs[i].second - runs[i].first);
+    return p;
+  };
+  const auto ph = prefix(high), pl = prefix(low);
+  const D m = ph.back();
+  if (m == 0) return first + total;
+
+  auto locate = [](const std::vector<std::pair<D, D>>& runs, const std::vector<D>& p, D k) {
+    std::size_t r = std::upper_bound(p.begin(), p.end(), k) - p.begin() - 1;
+    return std::pair{r, runs[r].first + (k - p[r])};
+  };
+
+  WorkStealingPool::Group g;
+  const D chunk = std::max<D>(parallel_grain, (m + pool.size() - 1) / pool.size());
+  for (D k0 = 0; k0 < m; k0 += chunk) {
+    pool.spawn(g, [&, k0] {
+      const D k1 = std::min(m, k0 + chunk);
+      auto [rh, ih] = locate(high, ph, k0);
+      auto [rl, il] = locate(low, pl, k0);
+      for (D k = k0; k < k1; ++k) {
+        if (ih == high[rh].second) ih = high[++rh].first;
+        if (il == low[rl].second) il = low[++rl].first;
+        std::iter_swap(first + ih++, first + il++);
+      }
+    });
+  }
+  pool.wait(g);
+  return first + total;
+}
+
+template <class I, class Comp, class Proj>
+void parallel_quicksort_loop(I first, I last, int depth, Comp comp, Proj proj,
+                             WorkStealingPool& pool, WorkStealingPool::Group& g) {
+  while (last - first > parallel_grain) {
+    if (depth-- == 0) {
+      std::ranges::make_heap(first, last, comp, proj);
+      std::ranges::sort_heap(first, last, comp, proj);
+      return;
+    }
+
+    I mid;
+    if (last - first > parallel_partition_threshold && pool.size() > 1) {
+      const auto pivot_key = std::invoke(proj, *choose_pivot(first, last, comp, proj));
+      mid = parallel_partition(first, last, [&](auto&& x) { return comp(std::invoke(proj, x), pivot_key); }, pool);
+      if (mid == first) {
+        // Nothing below the pivot: peel off the run equal to it, which is already in place.
+        first = parallel_partition(first, last, [&](auto&& x) { return !comp(pivot_key, std::invoke(proj, x)); }, pool);
+        continue;
+      }
+    } else {
+      I left  = first;
+      I right = last - 1;
+      const auto pivot_key = std::invoke(proj, *choose_pivot(first, last, comp, proj));
+      while (true) {
+        while (comp(std::invoke(proj, *left),  pivot_key)) ++left;
+        while (comp(pivot_key, std::invoke(proj, *right))) --right;
+        if (!(left < right)) break;
+        std::iter_swap(left++, right--);
+      }
+      mid = right + 1;
+    }
+
+    if (mid - first < last - mid) {
+      pool.spawn(g, [=, &pool, &g] { parallel_quicksort_loop(first, mid, depth, comp, proj, pool, g); });
       first = mid;
     } else {
-      quicksort(mid, last, comp, proj);
+      pool.spawn(g, [=, &pool, &g] { parallel_quicksort_loop(mid, last, depth, comp, proj, pool, g); });
       last = mid;
     }
   }
+  introsort_loop(first, last, depth, comp, proj);
+}
+
+} // namespace detail
+
+template <std::random_access_iterator I,
+          class Comp = std::ranges::less,
+          class Proj = std::identity>
+requires std::sortable<I, Comp, Proj>
+void parallel_quicksort(I first, I last, Comp comp, Proj proj, WorkStealingPool& pool) {
+  if (last - first < 2) return;
+  const int depth = 2 * detail::depth_limit(first, last);
+  WorkStealingPool::Group g;
+  detail::parallel_quicksort_loop(first, last, depth, comp, proj, pool, g);
+  pool.wait(g);
+}
+
+template <class K>
+concept RadixKey =
+  (std::integral<K> && (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 || sizeof(K) == 8)) ||
+  (std::floating_point<K> && std::numeric_limits<K>::is_iec559 && (sizeof(K) == 4 || sizeof(K) == 8));
+
+namespace detail {
+
+inline constexpr std::ptrdiff_t radix_threshold = 256;
+
+template <std::size_t N> struct unsigned_of;
+template <> struct unsigned_of<1> { using type = std::uint8_t; };
+template <> struct unsigned_of<2> { using type = std::uint16_t; };
+template <> struct unsigned_of<4> { using type = std::uint32_t; };
+template <> struct unsigned_of<8> { using type = std::uint64_t; };
+
+// Maps a key to unsigned bits whose unsigned order matches the key's order.
+template <RadixKey K, bool Descending>
+auto radix_bits(K k) noexcept {
+  using U = typename unsigned_of<sizeof(K)>::type;
+  constexpr U sign = U(1) << (8 * sizeof(K) - 1);
+  U u;
+  if constexpr (std::same_as<K, bool>) u = k;
+  else if constexpr (std::floating_point<K>) {
+    u = std::bit_cast<U>(k);
+    u = (u & sign) ? U(~u) : U(u | sign);
+  } else if constexpr (std::is_signed_v<K>) u = static_cast<U>(k) ^ sign;
+  else u = static_cast<U>(k);
+  if constexpr (Descending) u = ~u;
+  return u;
+}
+
+inline constexpr std::size_t lsd_cutoff = 1 << 16;
+
+template <class T, class Bits>
+void radix_core(T* a, T* tmp, std::size_t n, Bits& bits, WorkStealingPool* pool) {
+  using U = std::invoke_result_t<Bits&, const T&>;
+  constexpr std::size_t bytes = sizeof(U);
+  using Hist = std::array<std::array<std::size_t, 256>, bytes>;
+
+  if (n < std::size_t(radix_threshold)) {
+    auto less = [&](const T& x, const T& y) { return bits(x) < bits(y); };
+    pdq_loop(a, a + n, less, depth_limit(a, a + n), true);
+    return;
+  }
+
+  // One read of the input fills the histograms of every digit.
+  Hist hist{};
+  auto count = [&](std::size_t lo, std::size_t hi, Hist& h) {
+    for (std::size_t i = lo; i < hi; ++i) {
+      const U u = bits(a[i]);
+      for (std::size_t b = 0; b < bytes; ++b) ++h[b][(u >> (8 * b)) & 0xff];
+    }
+  };
+  const bool parallel = pool && pool->size() > 1 && n >= std::size_t(parallel_grain) * 4;
+  if (parallel) {
+    const std::size_t parts = std::min<std::size_t>(pool->size(), n / parallel_grain);
+    std::vector<Hist> local(parts, Hist{});
+    WorkStealingPool::Group g;
+    for (std::size_t t = 0; t < parts; ++t)
+      pool->spawn(g, [&, t] { count(n * t / parts, n * (t + 1) / parts, local[t]); });
+    pool->wait(g);
+    for (auto& h : local)
+      for (std::size_t b = 0; b < bytes; ++b)
+        for (std::size_t d = 0; d < 256; ++d) hist[b][d] += h[b][d];
+  } else {
+    count(0, n, hist);
+  }
+
+  auto scatter = [&](const T* src, T* dst, std::size_t b, std::array<std::size_t, 256>& pos) {
+    for (std::size_t i = 0; i < n; ++i) dst[pos[(bits(src[i]) >> (8 * b)) & 0xff]++] = src[i];
+  };
+  auto constant = [&](std::size_t b) { return std::ranges::find(hist[b], n) != hist[b].end(); };
+
+  if (n <= lsd_cutoff) {
+    T* src = a;
+    T* dst = tmp;
+    for (std::size_t b = 0; b < bytes; ++b) {
+      if (constant(b)) continue;
+      std::array<std::size_t, 256> pos;
+      std::exclusive_scan(hist[b].begin(), hist[b].end(), pos.begin(), std::size_t{0});
+      scatter(src, dst, b, pos);
+      std::swap(src, dst);
+    }
+    if (src != a) std::copy(src, src + n, a);
+    return;
+  }
+
+  // Too large for the scatter to stay in cache: split on the top varying digit, then LSD each bucket.
+  std::size_t top = bytes;
+  while (top > 0 && constant(top - 1)) --top;
+  if (top == 0) return;
+  const std::size_t b = top - 1;
+
+  std::array<std::size_t, 257> start{};
+  std::inclusive_scan(hist[b].begin(), hist[b].end(), start.begin() + 1);
+  std::array<std::size_t, 256> pos;
+  std::copy(start.begin(), start.end() - 1, pos.begin());
+  scatter(a, tmp, b, pos);
+
+  auto bucket = [&, a, tmp](std::size_t d) {
+    const std::size_t lo = start[d], len = start[d + 1] - lo;
+    radix_core(tmp + lo, a + lo, len, bits, nullptr);
+    std::copy(tmp + lo, tmp + lo + len, a + lo);
+  };
+  if (parallel) {
+    WorkStealingPool::Group g;
+    for (std::size_t d = 0; d < 256; ++d)
+      if (start[d + 1] > start[d]) pool->spawn(g, [&, d] { bucket(d); });
+    pool->wait(g);
+  } else {
+    for (std::size_t d = 0; d < 256; ++d)
+      if (start[d + 1] > start[d]) bucket(d);
+  }
+}
+
+template <bool Descending, class I, class Proj>
+void radix_sort_impl(I first, I last, Proj& proj, WorkStealingPool* pool) {
+  using V = std::iter_value_t<I>;
+  using K = std::remove_cvref_t<std::invoke_result_t<Proj&, std::iter_reference_t<I>>>;
+  const std::size_t n = last - first;
+
+  if constexpr (std::is_trivially_copyable_v<V> && std::is_trivially_default_constructible_v<V> &&
+                std::contiguous_iterator<I>) {
+    auto bits = [&](const V& v) { return radix_bits<K, Descending>(std::invoke(proj, v)); };
+    std::vector<V> tmp(n);
+    radix_core(std::to_address(first), tmp.data(), n, bits, pool);
+  } else {
+    // Sort (key, index) pairs instead of moving the records on every pass, then permute once.
+    using U = decltype(radix_bits<K, Descending>(K{}));
+    struct Item { U key; std::size_t index; };
+    std::vector<Item> items(n), tmp(n);
+    for (std::size_t i = 0; i < n; ++i) items[i] = {radix_bits<K, Descending>(std::invoke(proj, first[i])), i};
+    auto bits = [](const Item& it) { return it.key; };
+    radix_core(items.data(), tmp.data(), n, bits, pool);
+
+    std::vector<V> out;
+    out.reserve(n);
+    for (const Item& it : items) out.push_back(std::ranges::iter_move(first + it.index));
+    std::ranges::move(out, first);
+  }
+}
+
+} // namespace detail
+
+// Radix sort over 8-bit digits when the projected key is a plain integer or IEEE float and the
+// order is std::ranges::less / greater; any other key or comparator falls back to quicksort.
+template <std::random_access_iterator I,
+          class Comp = std::ranges::less,
+          class Proj = std::identity>
+requires std::sortable<I, Comp, Proj>
+void radix_sort(I first, I last, Comp comp = {}, Proj proj = {}, WorkStealingPool* pool = nullptr) {
+  using K = std::remove_cvref_t<std::invoke_result_t<Proj&, std::iter_reference_t<I>>>;
+  constexpr bool descending = detail::is_greater_v<Comp, K>;
+
+  if constexpr (RadixKey<K> && (detail::is_less_v<Comp, K> || descending)) {
+    if (last - first >= detail::radix_threshold) {
+      detail::radix_sort_impl<descending>(first, last, proj, pool);
+      return;
+    }
+  }
+  quicksort<BlockPartition>(first, last, comp, proj);
+}
+
+struct ExternalSortOptions {
+  std::size_t memory_budget = std::size_t{256} << 20;  // bytes for one in-memory run
+  std::size_t io_block = std::size_t{1} << 20;          // bytes buffered per run while merging
+  std::size_t header_bytes = 0;                         // leading bytes copied to the output unsorted
+  std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+};
+
+namespace detail {
+
+using unique_file = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+inline unique_file open_file(const std::filesystem::path& p, const char* mode) {
+  unique_file f(std::fopen(p.c_str(), mode), &std::fclose);
+  if (!f) throw std::runtime_error("cannot open " + p.string());
+  return f;
+}
+
+inline void read_exact(std::FILE* f, void* dst, std::size_t size, std::size_t n) {
+  if (n && std::fread(dst, size, n, f) != n) throw std::runtime_error("short read");
+}
+
+inline void write_exact(std::FILE* f, const void* src, std::size_t size, std::size_t n) {
+  if (n && std::fwrite(src, size, n, f) != n) throw std::runtime_error("short write");
+}
+
+inline void close_file(unique_file& f) {
+  if (std::fclose(f.release()) != 0) throw std::runtime_error("close failed");
+}
+
+template <class R>
+class RunReader {
+  unique_file f_;
+  std::vector<R> buf_;
+  std::size_t pos_ = 0, len_ = 0;
+  std::uint64_t left_;
+
+  void refill() {
+    len_ = static_cast<std::size_t>(std::min<std::uint64_t>(buf_.size(), left_));
+    pos_ = 0;
+    read_exact(f_.get(), buf_.data(), sizeof(R), len_);
+    left_ -= len_;
+  }
+
+public:
+  RunReader(const std::filesystem::path& p, std::size_t block)
+    : f_(open_file(p, "rb")), left_(std::filesystem::file_size(p) / sizeof(R)) {
+    buf_.resize(static_cast<std::size_t>(std::clamp<std::uint64_t>(left_, 1, block)));
+    refill();
+  }
+
+  bool done() const noexcept { return pos_ == len_; }
+  const R& head() const noexcept { return buf_[pos_]; }
+  void next() {
+    if (++pos_ == len_) refill();
+  }
+};
+
+template <class R>
+class RunWriter {
+  unique_file f_;
+  std::vector<R> buf_;
+  std::size_t len_ = 0;
+
+public:
+  RunWriter(unique_file f, std::size_t block) : f_(std::move(f)), buf_(block) {}
+
+  void push(const R& r) {
+    buf_[len_++] = r;
+    if (len_ == buf_.size()) flush();
+  }
+  void flush() {
+    write_exact(f_.get(), buf_.data(), sizeof(R), len_);
+    len_ = 0;
+  }
+  void close() {
+    flush();
+    close_file(f_);
+  }
+};
+
+// Owns the spilled runs; whatever is still listed is deleted on the way out, including on error.
+class TempRuns {
+  std::filesystem::path dir_;
+  std::string prefix_;
+  std::size_t next_ = 0;
+
+public:
+  std::deque<std::filesystem::path> live;
+
+  explicit TempRuns(std::filesystem::path dir)
+    : dir_(std::move(dir)), prefix_("extsort-" + std::to_string(std::random_device{}()) + "-") {}
+  TempRuns(const TempRuns&) = delete;
+  TempRuns& operator=(const TempRuns&) = delete;
+  ~TempRuns() { drop(live.size()); }
+
+  unique_file create() {
+    live.push_back(dir_ / (prefix_ + std::to_string(next_++) + ".run"));
+    return open_file(live.back(), "wbx");
+  }
+  void drop(std::size_t n) {
+    std::error_code ec;
+    for (; n > 0; --n, live.pop_front()) std::filesystem::remove(live.front(), ec);
+  }
+};
+
+// k-way merge through a loser tree: leaf i sits at k + i, node[p] keeps the loser of the match at p
+// and node[0] the overall winner, so each output record costs one replay of log2(k) comparisons.
+template <class R, class Comp, class Proj>
+void merge_runs(std::span<const std::filesystem::path> runs, RunWriter<R>& out, std::size_t block,
+                Comp& comp, Proj& proj) {
+  std::vector<RunReader<R>> in;
+  in.reserve(runs.size());
+  for (const auto& p : runs) in.emplace_back(p, block);
+
+  const std::size_t k = in.size();
+  auto beats = [&](std::size_t a, std::size_t b) {
+    if (in[a].done()) return false;
+    if (in[b].done()) return true;
+    return std::invoke(comp, std::invoke(proj, in[a].head()), std::invoke(proj, in[b].head()));
+  };
+
+  std::vector<std::size_t> node(k), win(2 * k);
+  for (std::size_t i = 0; i < k; ++i) win[k + i] = i;
+  for (std::size_t p = k - 1; p > 0; --p) {
+    std::size_t a = win[2 * p], b = win[2 * p + 1];
+    if (beats(b, a)) std::swap(a, b);
+    win[p] = a;
+    node[p] = b;
+  }
+  node[0] = win[1];
+
+  while (!in[node[0]].done()) {
+    std::size_t w = node[0];
+    out.push(in[w].head());
+    in[w].next();
+    for (std::size_t p = (w + k) / 2; p > 0; p /= 2)
+      if (beats(node[p], w)) std::swap(node[p], w);
+    node[0] = w;
+  }
+}
+
+} // namespace detail
+
+// Sorts a file of fixed-size records R that may be far larger than memory: memory_budget-sized
+// runs are sorted with quicksort and spilled to temp_dir, then merged with large sequential reads.
+// Input and output may name the same file.
+template <class R,
+          class Comp = std::ranges::less,
+          class Proj = std::identity>
+requires std::is_trivially_copyable_v<R> && std::default_initializable<R> && std::sortable<R*, Comp, Proj>
+void external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+                   Comp comp = {}, Proj proj = {}, const ExternalSortOptions& opt = {}) {
+  const std::uintmax_t bytes = std::filesystem::file_size(input);
+  if (bytes < opt.header_bytes || (bytes - opt.header_bytes) % sizeof(R) != 0)
+    throw std::runtime_error("external_sort: file is not a whole number of records");
+
+  const std::uint64_t total = (bytes - opt.header_bytes) / sizeof(R);
+  const std::size_t run_len = std::max<std::size_t>(opt.memory_budget / sizeof(R), 1);
+  const std::size_t block = std::max<std::size_t>(opt.io_block / sizeof(R), 1);
+  const std::size_t fan_in = std::max<std::size_t>(opt.memory_budget / std::max<std::size_t>(opt.io_block, 1), 3) - 1;
+  const bool in_memory = total <= run_len;
+
+  std::vector<char> header(opt.header_bytes);
+  std::vector<R> buf(static_cast<std::size_t>(std::min<std::uint64_t>(total, run_len)));
+  detail::TempRuns runs(opt.temp_dir);
+  {
+    auto in = detail::open_file(input, "rb");
+    detail::read_exact(in.get(), header.data(), 1, header.size());
+    for (std::uint64_t left = total; left > 0;) {
+      const auto len = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size(), left));
+      detail::read_exact(in.get(), buf.data(), sizeof(R), len);
+      left -= len;
+      quicksort<BlockPartition>(buf.begin(), buf.begin() + len, comp, proj);
+      if (in_memory) break;
+      auto f = runs.create();
+      detail::write_exact(f.get(), buf.data(), sizeof(R), len);
+      detail::close_file(f);
+    }
+  }
+
+  if (in_memory) {
+    auto out = detail::open_file(output, "wb");
+    detail::write_exact(out.get(), header.data(), 1, header.size());
+    detail::write_exact(out.get(), buf.data(), sizeof(R), buf.size());
+    detail::close_file(out);
+    return;
+  }
+  std::vector<R>().swap(buf);
+
+  // Too many runs to merge within the budget: merge the oldest fan_in into a new run until they fit.
+  while (runs.live.size() > fan_in) {
+    std::vector<std::filesystem::path> group(runs.live.begin(), runs.live.begin() + fan_in);
+    detail::RunWriter<R> w(runs.create(), block);
+    detail::merge_runs<R>(group, w, block, comp, proj);
+    w.close();
+    runs.drop(fan_in);
+  }
+
+  std::vector<std::filesystem::path> last(runs.live.begin(), runs.live.end());
+  auto out = detail::open_file(output, "wb");
+  detail::write_exact(out.get(), header.data(), 1, header.size());
+  detail::RunWriter<R> w(std::move(out), block);
+  detail::merge_runs<R>(last, w, block, comp, proj);
+  w.close();
 }
@@ -0,0 +1,324 @@
+#include "sort.cpp"
+
+// Usage: sort_bench [--min-exp 3] [--max-exp 7] [--reps 3] [--count-limit 10000000]
+//                   [--algos hoare,block,simd,radix,std_sort,std_stable_sort,parallel]
+//                   [--dists uniform,sorted,reversed,organ_pipe,few_unique,zipf] [--types int64,record128]
+//                   [--threads max]
+//        sort_bench --external [records]
+// Prints one JSON document to stdout. parallel runs parallel_quicksort once per pool size
+// 1, 2, 4, ... up to --threads (default: hardware threads) and reports speedup over one thread.
+// --external sorts a temporary record file with a budget small enough to force several merge
+// passes, verifies the output and exits non-zero on a mismatch.
+
+struct Record {
+  std::int64_t key;
+  std::array<std::byte, 120> payload;
+};
+
+struct Counters {
+  std::uint64_t comparisons = 0, swaps = 0, moves = 0;
+};
+
+inline Counters counters;
+
+// Element wrapper that counts swaps and moves/copies; used only for the counting pass.
+template <class T>
+struct Counted {
+  T v;
+
+  Counted() = default;
+  explicit Counted(const T& x) : v(x) {}
+  Counted(const Counted& o) : v(o.v) { ++counters.moves; }
+  Counted(Counted&& o) noexcept : v(std::move(o.v)) { ++counters.moves; }
+  Counted& operator=(const Counted& o) { v = o.v; ++counters.moves; return *this; }
+  Counted& operator=(Counted&& o) noexcept { v = std::move(o.v); ++counters.moves; return *this; }
+  friend void swap(Counted& a, Counted& b) noexcept {
+    ++counters.swaps;
+    std::swap(a.v, b.v);
+  }
+};
+
+struct Options {
+  int min_exp = 3, max_exp = 7, reps = 3;
+  std::size_t count_limit = 10'000'000;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::string> algos{"hoare", "block", "simd", "radix", "std_sort", "std_stable_sort", "parallel"};
+  std::vector<std::string> dists{"uniform", "sorted", "reversed", "organ_pipe", "few_unique", "zipf"};
+  std::vector<std::string> types{"int64", "record128"};
+};
+
+std::vector<std::string> split(std::string_view s) {
+  std::vector<std::string> out;
+  for (auto part : s | std::views::split(',')) out.emplace_back(part.begin(), part.end());
+  return out;
+}
+
+// Every name is checked before anything is printed, so a typo cannot leave half a JSON document.
+void validate(const std::vector<std::string>& names, std::initializer_list<std::string_view> known, const char* what) {
+  for (const auto& n : names)
+    if (std::ranges::find(known, n) == known.end()) throw std::runtime_error("unknown " + std::string(what) + " " + n);
+}
+
+Options parse(int argc, char** argv) {
+  Options o;
+  for (int i = 1; i < argc; i += 2) {
+    if (i + 1 == argc) throw std::runtime_error("missing value for " + std::string(argv[i]));
+    std::string_view k = argv[i], v = argv[i + 1];
+    auto num = [&](auto& out) {
+      const auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+      if (ec != std::errc{} || end != v.data() + v.size())
+        throw std::runtime_error("bad value for " + std::string(k) + ": " + std::string(v));
+    };
+    if (k == "--min-exp") num(o.min_exp);
+    else if (k == "--max-exp") num(o.max_exp);
+    else if (k == "--reps") num(o.reps);
+    else if (k == "--count-limit") num(o.count_limit);
+    else if (k == "--threads") num(o.threads);
+    else if (k == "--algos") o.algos = split(v);
+    else if (k == "--dists") o.dists = split(v);
+    else if (k == "--types") o.types = split(v);
+    else throw std::runtime_error("unknown option " + std::string(k));
+  }
+  if (o.threads == 0) throw std::runtime_error("--threads must be positive");
+  validate(o.algos, {"hoare", "block", "simd", "radix", "std_sort", "std_stable_sort", "parallel"}, "algorithm");
+  validate(o.dists, {"uniform", "sorted", "reversed", "organ_pipe", "few_unique", "zipf"}, "distribution");
+  validate(o.types, {"int64", "record128"}, "type");
+  return o;
+}
+
+std::vector<std::int64_t> generate(std::string_view dist, std::size_t n, std::mt19937_64& rng) {
+  std::vector<std::int64_t> v(n);
+  const auto m = static_cast<std::int64_t>(n);
+  if (dist == "uniform") for (auto& x : v) x = static_cast<std::int64_t>(rng());
+  else if (dist == "sorted") for (std::int64_t i = 0; i < m; ++i) v[i] = i;
+  else if (dist == "reversed") for (std::int64_t i = 0; i < m; ++i) v[i] = m - i;
+  else if (dist == "organ_pipe") for (std::int64_t i = 0; i < m; ++i) v[i] = i < m / 2 ? i : m - i;
+  else if (dist == "few_unique") for (auto& x : v) x = static_cast<std::int64_t>(rng() % 16);
+  else if (dist == "zipf") {
+    // s = 1 over up to 2^20 ranks, sampled by inverting the CDF.
+    std::vector<double> cdf(std::clamp<std::size_t>(n, 1, std::size_t{1} << 20));
+    double sum = 0;
+    for (std::size_t r = 0; r < cdf.size(); ++r) cdf[r] = sum += 1.0 / static_cast<double>(r + 1);
+    std::uniform_real_distribution<double> u(0, sum);
+    for (auto& x : v) x = std::ranges::lower_bound(cdf, u(rng)) - cdf.begin();
+  } else {
+    throw std::runtime_error("unknown distribution " + std::string(dist));
+  }
+  return v;
+}
+
+template <class E, class Comp, class Proj>
+void run_sort(std::string_view algo, std::vector<E>& v, Comp comp, Proj proj, WorkStealingPool* pool) {
+  if (algo == "hoare") quicksort<HoarePartition>(v.begin(), v.end(), comp, proj);
+  else if (algo == "block") quicksort<BlockPartition>(v.begin(), v.end(), comp, proj);
+  else if (algo == "simd") quicksort<SimdPartition>(v.begin(), v.end(), comp, proj);
+  else if (algo == "radix") radix_sort(v.begin(), v.end(), comp, proj);
+  else if (algo == "std_sort") std::ranges::sort(v, comp, proj);
+  else if (algo == "std_stable_sort") std::ranges::stable_sort(v, comp, proj);
+  else if (algo == "parallel") parallel_quicksort(v.begin(), v.end(), comp, proj, *pool);
+  else throw std::runtime_error("unknown algorithm " + std::string(algo));
+}
+
+// simd and radix dispatch on the exact comparator type, so a counting comparator would
+// benchmark the fallback instead; parallel would race on the counters. Their counts are null.
+bool countable(std::string_view algo) { return algo != "simd" && algo != "radix" && algo != "parallel"; }
+
+struct Result {
+  double ns_per_elem;
+  bool ok;
+  std::optional<Counters> counts;
+};
+
+template <class E, class Proj>
+Result measure(std::string_view algo, const std::vector<E>& base, const std::vector<std::int64_t>& expect,
+               Proj proj, const Options& opt, WorkStealingPool* pool = nullptr) {
+  const std::size_t n = base.size();
+  const int reps = static_cast<int>(std::clamp<std::size_t>(10'000'000 / std::max<std::size_t>(n, 1), 1, opt.reps));
+  Result res{std::numeric_limits<double>::infinity(), true, std::nullopt};
+  std::vector<E> v;
+  for (int r = 0; r < reps; ++r) {
+    v = base;
+    auto t0 = std::chrono::steady_clock::now();
+    run_sort(algo, v, std::ranges::less{}, proj, pool);
+    std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+    res.ns_per_elem = std::min(res.ns_per_elem, dt.count() / static_cast<double>(n));
+  }
+  for (std::size_t i = 0; i < n && res.ok; ++i) res.ok = std::invoke(proj, v[i]) == expect[i];
+
+  if (countable(algo) && n <= opt.count_limit) {
+    std::vector<Counted<E>> c;
+    c.reserve(n);
+    for (const E& e : base) c.emplace_back(e);
+    counters = {};
+    auto less = [](const auto& a, const auto& b) { ++counters.comparisons; return a < b; };
+    auto cproj = [&](const Counted<E>& e) -> decltype(auto) { return std::invoke(proj, e.v); };
+    run_sort(algo, c, less, cproj, pool);
+    res.counts = counters;
+  }
+  return res;
+}
+
+int external(std::uint64_t n) {
+  const ExternalSortOptions eo{.memory_budget = 64 << 10, .io_block = 4 << 10, .header_bytes = 16,
+                               .temp_dir = std::filesystem::temp_directory_path() /
+                                           ("sort_bench-" + std::to_string(std::random_device{}()))};
+  const std::uint64_t run_len = eo.memory_budget / sizeof(Record), fan_in = eo.memory_budget / eo.io_block - 1;
+  const std::uint64_t runs = (n + run_len - 1) / run_len;
+  int merges = 1;
+  for (std::uint64_t r = runs; r > fan_in; r -= fan_in - 1) ++merges;
+  std::printf("%" PRIu64 " records, %" PRIu64 " runs, fan-in %" PRIu64 ", %d merges\n", n, runs, fan_in, merges);
+
+  // The payload carries the record's original index, so lost or duplicated records show up.
+  std::mt19937_64 rng(20240915);
+  std::vector<std::int64_t> keys(n);
+  const auto in = eo.temp_dir / "in.bin", out = eo.temp_dir / "out.bin";
+  std::filesystem::create_directory(eo.temp_dir);
+  const char header[16] = "sort_bench hdr";
+  {
+    auto f = detail::open_file(in, "wb");
+    detail::write_exact(f.get(), header, 1, sizeof header);
+    Record r;
+    for (std::uint64_t i = 0; i < n; ++i) {
+      // Keys in [-n/8, n/8) so that about four records share each key.
+      r.key = keys[i] = static_cast<std::int64_t>(rng() % std::max<std::uint64_t>(n / 4, 1) - n / 8);
+      r.payload.fill(static_cast<std::byte>(i));
+      std::memcpy(r.payload.data(), &i, sizeof i);
+      detail::write_exact(f.get(), &r, sizeof r, 1);
+    }
+    detail::close_file(f);
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  external_sort<Record>(in, out, std::ranges::less{}, &Record::key, eo);
+  std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+
+  std::uint64_t errors = 0;
+  {
+    if (std::filesystem::file_size(out) != sizeof header + n * sizeof(Record)) ++errors;
+    auto f = detail::open_file(out, "rb");
+    char h[sizeof header];
+    detail::read_exact(f.get(), h, 1, sizeof h);
+    if (std::memcmp(h, header, sizeof h) != 0) ++errors;
+    std::vector<bool> seen(n);
+    std::int64_t prev = std::numeric_limits<std::int64_t>::min();
+    Record r;
+    for (std::uint64_t i = 0; i < n && !errors; ++i) {
+      detail::read_exact(f.get(), &r, sizeof r, 1);
+      std::uint64_t idx;
+      std::memcpy(&idx, r.payload.data(), sizeof idx);
+      if (r.key < prev || idx >= n || seen[idx] || keys[idx] != r.key ||
+          r.payload.back() != static_cast<std::byte>(idx))
+        ++errors;
+      else
+        seen[idx] = true;
+      prev = r.key;
+    }
+  }
+  std::filesystem::remove(in);
+  std::filesystem::remove(out);
+  // Every spilled run must have been deleted.
+  if (!std::filesystem::is_empty(eo.temp_dir)) ++errors;
+  std::filesystem::remove_all(eo.temp_dir);
+
+  std::printf("%.3f s, %s\n", dt.count(), errors ? "external sort failed" : "external sort passed");
+  return errors ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::string_view(argv[1]) == "--external") {
+    try {
+      std::uint64_t n = 1'000'000;
+      if (argc > 2) {
+        const std::string_view v = argv[2];
+        const auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), n);
+        if (ec != std::errc{} || end != v.data() + v.size()) {
+          std::fprintf(stderr, "usage: sort_bench --external [records]\n");
+          return 2;
+        }
+      }
+      return external(n);
+    } catch (const std::exception& e) {
+      std::fprintf(stderr, "sort_bench: %s\n", e.what());
+      return 1;
+    }
+  }
+  Options opt;
+  try {
+    opt = parse(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "sort_bench: %s\n"
+                         "usage: sort_bench [--min-exp 3] [--max-exp 7] [--reps 3] [--count-limit 10000000]\n"
+                         "                  [--algos hoare,block,simd,radix,std_sort,std_stable_sort,parallel]\n"
+                         "                  [--dists uniform,sorted,reversed,organ_pipe,few_unique,zipf]"
+                         " [--types int64,record128]\n"
+                         "                  [--threads max]\n"
+                         "       sort_bench --external [records]\n",
+                 e.what());
+    return 2;
+  }
+  std::mt19937_64 rng(20240901);
+  std::vector<std::unique_ptr<WorkStealingPool>> pools;
+  if (std::ranges::find(opt.algos, "parallel") != opt.algos.end())
+    for (unsigned t = 1;; t = std::min(2 * t, opt.threads)) {
+      pools.push_back(std::make_unique<WorkStealingPool>(t));
+      if (t == opt.threads) break;
+    }
+
+  std::printf("{\n  \"benchmark\": \"sort\",\n  \"results\": [");
+  bool first = true;
+  auto emit = [&](std::string_view type, std::string_view dist, std::string_view algo, std::size_t n, const Result& r,
+                  unsigned threads = 0, double speedup = 0) {
+    std::printf("%s\n    {\"type\": \"%.*s\", \"distribution\": \"%.*s\", \"algorithm\": \"%.*s\", \"n\": %zu, "
+                "\"ns_per_elem\": %.3f, \"ok\": %s, ",
+                first ? "" : ",", int(type.size()), type.data(), int(dist.size()), dist.data(),
+                int(algo.size()), algo.data(), n, r.ns_per_elem, r.ok ? "true" : "false");
+    if (threads) std::printf("\"threads\": %u, \"speedup\": %.2f, ", threads, speedup);
+    if (r.counts)
+      std::printf("\"comparisons\": %" PRIu64 ", \"swaps\": %" PRIu64 ", \"moves\": %" PRIu64 "}",
+                  r.counts->comparisons, r.counts->swaps, r.counts->moves);
+    else
+      std::printf("\"comparisons\": null, \"swaps\": null, \"moves\": null}");
+    std::fflush(stdout);
+    first = false;
+  };
+
+  for (int e = opt.min_exp; e <= opt.max_exp; ++e) {
+    std::size_t n = 1;
+    for (int i = 0; i < e; ++i) n *= 10;
+    for (const auto& dist : opt.dists) {
+      const std::vector<std::int64_t> keys = generate(dist, n, rng);
+      std::vector<std::int64_t> expect = keys;
+      std::ranges::sort(expect);
+
+      auto run_all = [&](std::string_view type, const auto& base, auto proj) {
+        for (const auto& algo : opt.algos) {
+          if (algo != "parallel") {
+            emit(type, dist, algo, n, measure(algo, base, expect, proj, opt));
+            continue;
+          }
+          double one = 0;
+          for (const auto& pool : pools) {
+            const Result r = measure(algo, base, expect, proj, opt, pool.get());
+            if (pool->size() == 1) one = r.ns_per_elem;
+            emit(type, dist, algo, n, r, pool->size(), one / r.ns_per_elem);
+          }
+        }
+      };
+
+      for (const auto& type : opt.types) {
+        if (type == "int64") {
+          run_all(type, keys, std::identity{});
+        } else if (type == "record128") {
+          std::vector<Record> recs(n);
+          for (std::size_t i = 0; i < n; ++i) {
+            recs[i].key = keys[i];
+            recs[i].payload.fill(static_cast<std::byte>(i));
+          }
+          run_all(type, recs, &Record::key);
+        }
+      }
+    }
+  }
+  std::printf("\n  ]\n}\n");
+  return 0;
+}
@@ -1,10 +1,67 @@
 #include <bits/stdc++.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using i64 = long long;
 
-double eval_expr(std::string_view s) {
-  auto apply = [](std::vector<double> & v, std::vector<char> & o) {
+double read_number(std::string_view s, int& i) {
+  const int n = static_cast<int>(s.size());
+  double x = 0.0, base = 1.0;
+  bool has_int = false, has_frac = false;
+
+  while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { x = x * 10 + (s[i] - '0'); ++i; has_int = true; }
+  if (i < n && s[i] == '.') {
+    ++i;
+    while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { base /= 10.0; x += (s[i] - '0') * base; ++i; has_frac = true; }
+  }
+  if (!has_int && !has_frac) throw std::runtime_error("number expected");
+
+  if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+    ++i;
+    int sign = 1;
+    if (i < n && (s[i] == '+' || s[i] == '-')) { if (s[i] == '-') sign = -1; ++i; }
+    int expv = 0;
+    if (i >= n || !std::isdigit(static_cast<unsigned char>(s[i]))) throw std::runtime_error("bad exponent");
+    while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { expv = expv * 10 + (s[i] - '0'); ++i; }
+    x = x * std::pow(10.0, sign * expv);
+  }
+  return x;
+}
+
+// Thrown by the fixed-size stacks; callers fall back to the allocating path.
+struct ExpressionTooDeep : std::runtime_error {
+  ExpressionTooDeep() : std::runtime_error("expression too deep") {}
+};
+
+template <class T, std::size_t N>
+class FixedStack {
+  std::array<T, N> a_;
+  std::size_t n_ = 0;
+
+public:
+  void push_back(T x) {
+    if (n_ == N) throw ExpressionTooDeep();
+    a_[n_++] = x;
+  }
+  void pop_back() { --n_; }
+  T& back() { return a_[n_ - 1]; }
+  bool empty() const { return n_ == 0; }
+  std::size_t size() const { return n_; }
+};
+
+// Shared by eval_expr (std::vector stacks) and the file mode (FixedStack, no allocation).
+template <class Vals, class Ops>
+double eval_infix(std::string_view s, Vals& val, Ops& op) {
+  auto apply = [](Vals& v, Ops& o) {
     char op = o.back(); o.pop_back();
+    if (v.size() < (op == '!' ? 1u : 2u)) throw std::runtime_error("parse error");
     if (op == '!') {
       double a = v.back(); v.pop_back();
       v.push_back(-a);
@@ -28,8 +85,6 @@ double eval_expr(std::string_view s) {
 
   auto right_assoc = [](char op) { return op == '^' || op == '!'; };
 
-  std::vector<double> val;
-  std::vector<char> op;
   int n = static_cast<int>(s.size());
 
   auto isop = [](char c) { return c == '+' || c == '-' || c == '*' || c == '/' || c == '^'; };
@@ -64,27 +119,152 @@ double eval_expr(std::string_view s) {
     }
 
     if (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.') {
-      double x = 0.0, base = 1.0;
-      bool has_int = false, has_frac = false;
+      val.push_back(read_number(s, i));
+      expect_unary = 0;
+      continue;
+    }
+
+    throw std::runtime_error("invalid character");
+  }
+
+  while (!op.empty()) {
+    if (op.back() == '(') throw std::runtime_error("mismatched (");
+    apply(val, op);
+  }
+  if (val.size() != 1) throw std::runtime_error("parse error");
+  return val.back();
+}
+
+double eval_expr(std::string_view s) {
+  std::vector<double> val;
+  std::vector<char> op;
+  return eval_infix(s, val, op);
+}
+
+enum class Op : std::uint8_t { Const, Var, Neg, Add, Sub, Mul, Div, Pow };
+
+struct Instr {
+  Op op;
+  std::uint32_t arg;  // constant pool index for Const, variable slot for Var
+};
+
+// Postfix bytecode. Variable slot i is the i-th distinct name in order of first use.
+struct Program {
+  std::vector<Instr> code;
+  std::vector<double> consts;
+  std::vector<std::string> vars;
+  std::size_t depth = 0;  // peak stack use
+};
+
+// Stack entries the evaluators keep on the machine stack; deeper programs use a heap buffer.
+inline constexpr std::size_t max_eval_stack = 256;
+
+inline double apply_op(Op op, double a, double b) {
+  switch (op) {
+    case Op::Add: return a + b;
+    case Op::Sub: return a - b;
+    case Op::Mul: return a * b;
+    case Op::Div: return a / b;
+    default: return std::pow(a, b);
+  }
+}
+
+Program compile(std::string_view s) {
+  Program p;
+  std::vector<char> op;
+  // One entry per pending operand: true when it is a lone Const at the end of the code, so an
+  // operator applied to constants can be folded in place.
+  std::vector<bool> folded;
+  int n = static_cast<int>(s.size());
+
+  auto to_op = [](char c) {
+    if (c == '+') return Op::Add;
+    if (c == '-') return Op::Sub;
+    if (c == '*') return Op::Mul;
+    if (c == '/') return Op::Div;
+    return Op::Pow;
+  };
+
+  auto apply = [&](char c) {
+    if (c == '!') {
+      if (folded.empty()) throw std::runtime_error("parse error");
+      if (folded.back()) p.consts[p.code.back().arg] *= -1;
+      else p.code.push_back({Op::Neg, 0});
+      return;
+    }
+    if (folded.size() < 2) throw std::runtime_error("parse error");
+    const bool b_const = folded.back();
+    folded.pop_back();
+    if (folded.back() && b_const) {
+      const double b = p.consts.back();
+      p.consts.pop_back();
+      p.code.pop_back();
+      double& a = p.consts[p.code.back().arg];
+      a = apply_op(to_op(c), a, b);
+    } else {
+      p.code.push_back({to_op(c), 0});
+      folded.back() = false;
+    }
+  };
+
+  auto prec = [](char op) {
+    if (op == '^') return 4;
+    if (op == '!') return 3;
+    if (op == '*' || op == '/') return 2;
+    return 1;
+  };
+
+  auto right_assoc = [](char op) { return op == '^' || op == '!'; };
+  auto isop = [](char c) { return c == '+' || c == '-' || c == '*' || c == '/' || c == '^'; };
+  auto isname = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+  int expect_unary = 1;
+
+  for (int i = 0; i < n; ) {
+    if (std::isspace(static_cast<unsigned char>(s[i]))) { ++i; continue; }
+
+    if (s[i] == '(') { op.push_back('('); ++i; expect_unary = 1; continue; }
+
+    if (s[i] == ')') {
+      while (!op.empty() && op.back() != '(') { apply(op.back()); op.pop_back(); }
+      if (!op.empty() && op.back() == '(') op.pop_back();
+      ++i; expect_unary = 0; continue;
+    }
 
-      while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { x = x * 10 + (s[i] - '0'); ++i; has_int = true; }
-      if (i < n && s[i] == '.') {
-        ++i;
-        while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { base /= 10.0; x += (s[i] - '0') * base; ++i; has_frac = true; }
+    if (isop(s[i])) {
+      char c = s[i++];
+      if (expect_unary) {
+        if (c == '+') { continue; }
+        if (c == '-') { op.push_back('!'); continue; }
       }
-      if (!has_int && !has_frac) throw std::runtime_error("number expected");
-
-      if (i < n && (s[i] == 'e' || s[i] == 'E')) {
-        ++i;
-        int sign = 1;
-        if (i < n && (s[i] == '+' || s[i] == '-')) { if (s[i] == '-') sign = -1; ++i; }
-        int expv = 0;
-        if (i >= n || !std::isdigit(static_cast<unsigned char>(s[i]))) throw std::runtime_error("bad exponent");
-        while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) { expv = expv * 10 + (s[i] - '0'); ++i; }
-        x = x * std::pow(10.0, sign * expv);
+      while (!op.empty() && op.back() != '(' &&
+             (prec(op.back()) > prec(c) ||
+              (prec(op.back()) == prec(c) && !right_assoc(c)))) {
+        apply(op.back());
+        op.pop_back();
       }
+      op.push_back(c);
+      expect_unary = 1;
+      continue;
+    }
 
-      val.push_back(x);
+    if (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.') {
+      p.code.push_back({Op::Const, static_cast<std::uint32_t>(p.consts.size())});
+      p.consts.push_back(read_number(s, i));
+      folded.push_back(true);
+      expect_unary = 0;
+      continue;
+    }
+
+    if (std::isalpha(static_cast<unsigned char>(s[i])) || s[i] == '_') {
+      int j = i;
+      while (j < n && isname(s[j])) ++j;
+      std::string_view name = s.substr(i, j - i);
+      auto it = std::ranges::find(p.vars, name);
+      if (it == p.vars.end()) it = p.vars.emplace(p.vars.end(), name);
+      p.code.push_back({Op::Var, static_cast<std::uint32_t>(it - p.vars.begin())});
+      folded.push_back(false);
+      i = j;
       expect_unary = 0;
       continue;
     }
@@ -94,21 +274,446 @@ double eval_expr(std::string_view s) {
 
   while (!op.empty()) {
     if (op.back() == '(') throw std::runtime_error("mismatched (");
-    apply(val, op);
+    apply(op.back());
+    op.pop_back();
   }
-  if (val.size() != 1) throw std::runtime_error("parse error");
-  return val.back();
+  if (folded.size() != 1) throw std::runtime_error("parse error");
+
+  std::size_t depth = 0, max_depth = 0;
+  for (const Instr& in : p.code) {
+    if (in.op == Op::Const || in.op == Op::Var) max_depth = std::max(max_depth, ++depth);
+    else if (in.op != Op::Neg) --depth;
+  }
+  p.depth = max_depth;
+  return p;
+}
+
+namespace detail {
+
+inline double run_program(const Program& p, std::span<const double> vars, double* st) {
+  std::size_t sp = 0;
+  for (const Instr& in : p.code) {
+    switch (in.op) {
+      case Op::Const: st[sp++] = p.consts[in.arg]; break;
+      case Op::Var: st[sp++] = vars[in.arg]; break;
+      case Op::Neg: st[sp - 1] = -st[sp - 1]; break;
+      default: --sp; st[sp - 1] = apply_op(in.op, st[sp - 1], st[sp]);
+    }
+  }
+  return st[0];
+}
+
+} // namespace detail
+
+// Allocates only for programs deeper than max_eval_stack.
+double eval(const Program& p, std::span<const double> vars) {
+  if (vars.size() < p.vars.size()) throw std::runtime_error("missing variables");
+  if (p.depth > max_eval_stack) {
+    std::vector<double> st(p.depth);
+    return detail::run_program(p, vars, st.data());
+  }
+  std::array<double, max_eval_stack> st;
+  return detail::run_program(p, vars, st.data());
+}
+
+namespace batch {
+
+inline constexpr std::size_t chunk = 512;             // rows per block: a few stack columns fit in L1
+inline constexpr std::size_t rows_per_thread = 1 << 16;
+
+inline void binary_scalar(Op op, const double* a, const double* b, double* out, std::size_t n) {
+  switch (op) {
+    case Op::Add: for (std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i]; break;
+    case Op::Sub: for (std::size_t i = 0; i < n; ++i) out[i] = a[i] - b[i]; break;
+    case Op::Mul: for (std::size_t i = 0; i < n; ++i) out[i] = a[i] * b[i]; break;
+    case Op::Div: for (std::size_t i = 0; i < n; ++i) out[i] = a[i] / b[i]; break;
+    default: for (std::size_t i = 0; i < n; ++i) out[i] = std::pow(a[i], b[i]);
+  }
+}
+
+#if defined(__x86_64__)
+template <std::size_t N>
+[[gnu::target("avx2,fma")]] inline __m256d horner(__m256d x, __m256d r, const double (&c)[N]) {
+  for (double k : c) r = _mm256_fmadd_pd(r, x, _mm256_set1_pd(k));
+  return r;
+}
+
+// Cephes-style log and exp, valid for normal positive x and |y| <= 708 respectively.
+[[gnu::target("avx2,fma")]] inline __m256d log_avx2(__m256d x) {
+  const __m256i bits = _mm256_castpd_si256(x);
+  const __m256i exp_bits = _mm256_srli_epi64(bits, 52);
+  __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(exp_bits, _mm256_set1_epi64x(0x4330000000000000))),
+                            _mm256_set1_pd(4503599627370496.0 + 1022));
+  __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFF)),
+                                                  _mm256_set1_epi64x(0x3FE0000000000000)));
+  const __m256d small = _mm256_cmp_pd(m, _mm256_set1_pd(0.70710678118654752440), _CMP_LT_OQ);
+  e = _mm256_sub_pd(e, _mm256_and_pd(small, _mm256_set1_pd(1.0)));
+  m = _mm256_sub_pd(_mm256_add_pd(m, _mm256_and_pd(small, m)), _mm256_set1_pd(1.0));
+
+  const __m256d z = _mm256_mul_pd(m, m);
+  const __m256d p = horner(m, _mm256_set1_pd(1.01875663804580931796E-4),
+                           {4.97494994976747001425E-1, 4.70579119878881725854E0, 1.44989225341610930846E1,
+                            1.79368678507819816313E1, 7.70838733755885391666E0});
+  const __m256d q = horner(m, _mm256_add_pd(m, _mm256_set1_pd(1.12873587189167450590E1)),
+                           {4.52279145837532221105E1, 8.29875266912776603211E1, 7.11544750618563894466E1,
+                            2.31251620126765340583E1});
+  __m256d y = _mm256_mul_pd(m, _mm256_div_pd(_mm256_mul_pd(z, p), q));
+  y = _mm256_fnmadd_pd(e, _mm256_set1_pd(2.121944400546905827679e-4), y);
+  y = _mm256_fnmadd_pd(z, _mm256_set1_pd(0.5), y);
+  return _mm256_fmadd_pd(e, _mm256_set1_pd(0.693359375), _mm256_add_pd(m, y));
+}
+
+[[gnu::target("avx2,fma")]] inline __m256d exp_avx2(__m256d x) {
+  const __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634073599)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm256_fnmadd_pd(n, _mm256_set1_pd(6.93145751953125E-1), x);
+  x = _mm256_fnmadd_pd(n, _mm256_set1_pd(1.42860682030941723212E-6), x);
+  const __m256d xx = _mm256_mul_pd(x, x);
+  __m256d p = _mm256_fmadd_pd(_mm256_set1_pd(1.26177193074810590878E-4), xx, _mm256_set1_pd(3.02994407707441961300E-2));
+  p = _mm256_mul_pd(x, _mm256_fmadd_pd(p, xx, _mm256_set1_pd(9.99999999999999999910E-1)));
+  __m256d q = _mm256_fmadd_pd(_mm256_set1_pd(3.00198505138664455042E-6), xx, _mm256_set1_pd(2.52448340349684104192E-3));
+  q = _mm256_fmadd_pd(q, xx, _mm256_set1_pd(2.27265548208155028766E-1));
+  q = _mm256_fmadd_pd(q, xx, _mm256_set1_pd(2.00000000000000000009E0));
+  const __m256d r = _mm256_fmadd_pd(_mm256_set1_pd(2.0), _mm256_div_pd(p, _mm256_sub_pd(q, p)), _mm256_set1_pd(1.0));
+  const __m256i k = _mm256_slli_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)),
+                                                       _mm256_set1_epi64x(1023)), 52);
+  return _mm256_mul_pd(r, _mm256_castsi256_pd(k));
+}
+
+// pow(a, b) as exp(b * log(a)), within ~|b log a| * 1e-16 relative error. Lanes outside the
+// fast path (a <= 0, subnormal, non-finite, or a result near overflow) are redone with std::pow.
+[[gnu::target("avx2,fma")]] inline void pow_avx2(const double* a, const double* b, double* out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d x = _mm256_loadu_pd(a + i), e = _mm256_loadu_pd(b + i);
+    const __m256d y = _mm256_mul_pd(e, log_avx2(x));
+    __m256d ok = _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(DBL_MIN), _CMP_GE_OQ),
+                               _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ));
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+    ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_and_pd(y, abs_mask), _mm256_set1_pd(708.0), _CMP_LE_OQ));
+    const __m256d r = exp_avx2(_mm256_blendv_pd(_mm256_setzero_pd(), y, ok));
+    // out may alias a or b, so finish the lanes in a temporary and store once.
+    if (int bad = _mm256_movemask_pd(ok) ^ 0xF) {
+      alignas(32) double lanes[4];
+      _mm256_store_pd(lanes, r);
+      for (int l = 0; l < 4; ++l)
+        if (bad >> l & 1) lanes[l] = std::pow(a[i + l], b[i + l]);
+      _mm256_storeu_pd(out + i, _mm256_load_pd(lanes));
+    } else {
+      _mm256_storeu_pd(out + i, r);
+    }
+  }
+  for (; i < n; ++i) out[i] = std::pow(a[i], b[i]);
+}
+
+[[gnu::target("avx2,fma")]] inline void binary_avx2(Op op, const double* a, const double* b, double* out, std::size_t n) {
+  if (op == Op::Pow) return pow_avx2(a, b, out, n);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+    __m256d r;
+    switch (op) {
+      case Op::Add: r = _mm256_add_pd(x, y); break;
+      case Op::Sub: r = _mm256_sub_pd(x, y); break;
+      case Op::Mul: r = _mm256_mul_pd(x, y); break;
+      default: r = _mm256_div_pd(x, y);
+    }
+    _mm256_storeu_pd(out + i, r);
+  }
+  binary_scalar(op, a + i, b + i, out + i, n - i);
+}
+#endif
+
+using binary_fn = void (*)(Op, const double*, const double*, double*, std::size_t);
+
+inline binary_fn pick_binary() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return binary_avx2;
+#endif
+  return binary_scalar;
+}
+
+// Evaluates rows [row, row + m) one operator at a time; stack slot k lives at scratch + k * chunk,
+// and variables are read straight from their columns.
+inline void eval_block(const Program& p, std::span<const std::span<const double>> cols, std::size_t row,
+                       std::size_t m, double* out, double* scratch, const double** st, binary_fn binary) {
+  std::size_t sp = 0;
+  for (const Instr& in : p.code) {
+    double* dst = &in == &p.code.back() ? out : nullptr;
+    switch (in.op) {
+      case Op::Const:
+        st[sp] = dst ? dst : scratch + sp * chunk;
+        std::fill_n(const_cast<double*>(st[sp]), m, p.consts[in.arg]);
+        ++sp;
+        break;
+      case Op::Var:
+        st[sp++] = cols[in.arg].data() + row;
+        break;
+      case Op::Neg:
+        if (!dst) dst = scratch + (sp - 1) * chunk;
+        for (std::size_t i = 0; i < m; ++i) dst[i] = -st[sp - 1][i];
+        st[sp - 1] = dst;
+        break;
+      default:
+        --sp;
+        if (!dst) dst = scratch + (sp - 1) * chunk;
+        binary(in.op, st[sp - 1], st[sp], dst, m);
+        st[sp - 1] = dst;
+    }
+  }
+  if (st[0] != out) std::copy_n(st[0], m, out);
+}
+
+} // namespace batch
+
+// Columnar evaluation: out[i] = expression over row i of the variable columns. Rows are processed
+// in L1-sized blocks, one operator over the whole block at a time; large batches are split
+// across threads (0 = hardware_concurrency).
+void eval_batch(const Program& p, std::span<const std::span<const double>> cols, std::span<double> out,
+                unsigned threads = 0) {
+  if (cols.size() < p.vars.size()) throw std::runtime_error("missing variables");
+  for (std::size_t v = 0; v < p.vars.size(); ++v)
+    if (cols[v].size() < out.size()) throw std::runtime_error("column too short");
+
+  static const batch::binary_fn binary = batch::pick_binary();
+  const std::size_t n = out.size();
+  auto run = [&](std::size_t lo, std::size_t hi) {
+    std::vector<double> scratch(std::max<std::size_t>(p.depth, 1) * batch::chunk);
+    std::vector<const double*> st(std::max<std::size_t>(p.depth, 1));
+    for (std::size_t row = lo; row < hi; row += batch::chunk)
+      batch::eval_block(p, cols, row, std::min(batch::chunk, hi - row), out.data() + row, scratch.data(), st.data(),
+                        binary);
+  };
+
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned>(std::min<std::size_t>(threads, n / batch::rows_per_thread));
+  if (threads <= 1) return run(0, n);
+
+  const std::size_t per = (n / threads + batch::chunk - 1) / batch::chunk * batch::chunk;
+  std::vector<std::exception_ptr> err(threads);
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+      const std::size_t lo = std::min(n, t * per), hi = t + 1 == threads ? n : std::min(n, lo + per);
+      pool.emplace_back([&, t, lo, hi] {
+        try {
+          run(lo, hi);
+        } catch (...) {
+          err[t] = std::current_exception();
+        }
+      });
+    }
+  }
+  for (auto& e : err)
+    if (e) std::rethrow_exception(e);
 }
 
-int main() {
+// Read-only view of a whole file: mmap on POSIX, a plain read elsewhere.
+class MappedFile {
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::vector<char> copy_;
+
+public:
+  explicit MappedFile(const char* path) {
+#if defined(__unix__)
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) throw std::runtime_error(std::string("cannot open ") + path);
+    struct stat st {};
+    if (::fstat(fd, &st) == 0) size_ = static_cast<std::size_t>(st.st_size);
+    if (size_) {
+      void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error(std::string("cannot map ") + path);
+      }
+      ::madvise(p, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    copy_.assign(std::istreambuf_iterator<char>(in), {});
+    data_ = copy_.data();
+    size_ = copy_.size();
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+#if defined(__unix__)
+    if (size_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  std::string_view view() const { return {data_, size_}; }
+};
+
+inline constexpr std::size_t file_chunk = std::size_t{4} << 20;
+
+// Evaluates every line of text, appending one result per line (or "error") to out.
+inline void eval_lines(std::string_view text, std::string& out) {
+  char buf[512];
+  while (!text.empty()) {
+    std::size_t nl = text.find('\n');
+    std::string_view line = text.substr(0, nl);
+    text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    FixedStack<double, max_eval_stack> val;
+    FixedStack<char, max_eval_stack> op;
+    try {
+      double v;
+      try {
+        v = eval_infix(line, val, op);
+      } catch (const ExpressionTooDeep&) {
+        // Rare deep line: the allocating stacks give the same result as eval_expr.
+        v = eval_expr(line);
+      }
+      auto [end, ec] = std::to_chars(buf, buf + sizeof buf, v, std::chars_format::fixed, 12);
+      out.append(buf, end);
+    } catch (const std::runtime_error&) {
+      out += "error";
+    }
+    out += '\n';
+  }
+}
+
+// Evaluates a file with one expression per line. The input is cut into line-aligned chunks;
+// each round hands one chunk to each thread and writes their outputs in input order.
+void eval_file(const char* in_path, std::FILE* out, unsigned threads = 0) {
+  const MappedFile file(in_path);
+  std::string_view text = file.view();
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<std::string> bufs(threads);
+  while (!text.empty()) {
+    std::vector<std::string_view> parts;
+    for (unsigned t = 0; t < threads && !text.empty(); ++t) {
+      std::size_t cut = std::min(text.size(), file_chunk);
+      if (cut < text.size()) {
+        std::size_t nl = text.find('\n', cut - 1);
+        cut = nl == std::string_view::npos ? text.size() : nl + 1;
+      }
+      parts.push_back(text.substr(0, cut));
+      text.remove_prefix(cut);
+    }
+
+    for (auto& b : bufs) b.clear();
+    if (parts.size() == 1) {
+      eval_lines(parts[0], bufs[0]);
+    } else {
+      std::vector<std::jthread> pool;
+      pool.reserve(parts.size());
+      for (std::size_t t = 0; t < parts.size(); ++t) pool.emplace_back([&, t] { eval_lines(parts[t], bufs[t]); });
+    }
+    for (std::size_t t = 0; t < parts.size(); ++t)
+      if (std::fwrite(bufs[t].data(), 1, bufs[t].size(), out) != bufs[t].size()) throw std::runtime_error("write failed");
+  }
+}
+
+void bench() {
+  const std::string_view formula = "(x * x + 3.5 * y - (x - y) / 2 ^ 2) * -(1 + 2 * 3)";
+  const Program prog = compile(formula);
+
+  std::vector<std::array<double, 2>> inputs(1000);
+  std::vector<std::string> texts;
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> u(-100, 100);
+  for (auto& in : inputs) {
+    // Three decimals, so the text that eval_expr reparses holds the same values.
+    in = {std::round(u(rng) * 1000) / 1000, std::round(u(rng) * 1000) / 1000};
+    std::string t;
+    for (char c : formula) {
+      if (c == 'x' || c == 'y') t += '(' + std::to_string(in[c - 'x']) + ')';
+      else t += c;
+    }
+    texts.push_back(std::move(t));
+  }
+
+  auto run = [&](auto&& f) {
+    const int rounds = 1000;
+    double sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+      for (std::size_t k = 0; k < inputs.size(); ++k) sum += f(k);
+    std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+    return std::pair{dt.count() / (rounds * inputs.size()), sum};
+  };
+  auto [t_str, s_str] = run([&](std::size_t k) { return eval_expr(texts[k]); });
+  auto [t_prog, s_prog] = run([&](std::size_t k) { return eval(prog, inputs[k]); });
+
+  std::vector<double> xs, ys, out(inputs.size());
+  for (const auto& in : inputs) xs.push_back(in[0]), ys.push_back(in[1]);
+  const std::array<std::span<const double>, 2> cols{xs, ys};
+  std::size_t k = 0;
+  auto [t_batch, s_batch] = run([&](std::size_t) {
+    if (k == 0) eval_batch(prog, cols, out, 1);
+    double r = out[k];
+    k = (k + 1) % out.size();
+    return r;
+  });
+
+  std::cout << std::setprecision(1) << "eval_expr:    " << t_str << " ns/eval\n"
+            << "compile+eval: " << t_prog << " ns/eval (" << prog.code.size() << " instructions)\n"
+            << "eval_batch:   " << t_batch << " ns/row\n"
+            << std::scientific << "relative checksum difference " << std::abs(s_str - s_prog) / std::abs(s_prog)
+            << ", batch " << std::abs(s_batch - s_prog) / std::abs(s_prog) << '\n';
+}
+
+int main(int argc, char** argv) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
   std::cout.tie(nullptr);
 
+  std::cout.setf(std::ios::fixed);
+  if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+    bench();
+    return 0;
+  }
+  // expr --file <input> [output]: one expression per line, results in the same order.
+  if (argc > 1 && std::string_view(argv[1]) == "--file") {
+    if (argc < 3) {
+      std::cerr << "usage: expr --file <input> [output]\n";
+      return 2;
+    }
+    std::FILE* out = argc > 3 ? std::fopen(argv[3], "wb") : stdout;
+    if (!out) {
+      std::cerr << "expr: cannot open " << argv[3] << ": " << std::strerror(errno) << '\n';
+      return 1;
+    }
+    try {
+      eval_file(argv[2], out);
+    } catch (const std::exception& e) {
+      std::cerr << "expr: " << e.what() << '\n';
+      if (out != stdout) std::fclose(out);
+      return 1;
+    }
+    if (out != stdout ? std::fclose(out) != 0 : std::fflush(out) != 0) {
+      std::cerr << "expr: write failed: " << std::strerror(errno) << '\n';
+      return 1;
+    }
+    return 0;
+  }
+
   std::string expr;
   if (!std::getline(std::cin, expr)) return 0;
 
-  std::cout.setf(std::ios::fixed);
-  std::cout << std::setprecision(12) << eval_expr(expr) << '\n';
+  // Variables, if any, follow on the next line in order of first appearance.
+  try {
+    const Program prog = compile(expr);
+    std::vector<double> vars(prog.vars.size());
+    for (std::size_t i = 0; i < vars.size(); ++i)
+      if (!(std::cin >> vars[i])) throw std::runtime_error("missing value for " + prog.vars[i]);
+
+    std::cout << std::setprecision(12) << eval(prog, vars) << '\n';
+  } catch (const std::exception& e) {
+    std::cerr << "expr: " << e.what() << '\n';
+    return 1;
+  }
   return 0;
 }
@@ -22,14 +22,193 @@ void hanoi_iter_gray(unsigned n, std::array<char, 3> names = {'A','B','C'}) {
   }
 }
 
-int main() {
+struct Move {
+  unsigned disk;
+  int from, to;
+};
+
+// Disk d moves on the steps m with countr_zero(m) == d - 1, always cycling in the same
+// direction, so after step k it has made ((k >> (d - 1)) + 1) >> 1 moves.
+inline int hanoi_dir(unsigned n, unsigned disk) {
+  const int dir_odd = (n % 2 == 0) ? 1 : 2;
+  return (disk & 1) ? dir_odd : 3 - dir_odd;
+}
+
+inline int peg_after(unsigned n, unsigned disk, u64 k) {
+  const u64 moves = ((k >> (disk - 1)) + 1) >> 1;
+  return static_cast<int>(moves % 3) * hanoi_dir(n, disk) % 3;
+}
+
+void check_hanoi(unsigned n, u64 k) {
+  if (n > 63) throw std::runtime_error("n must be at most 63");
+  if (k > (1ULL << n) - 1) throw std::runtime_error("move index out of range");
+}
+
+// The k-th move (1-based) of the optimal n-disk solution, in O(1).
+Move move_at(unsigned n, u64 k) {
+  check_hanoi(n, k);
+  if (k == 0) throw std::runtime_error("move index out of range");
+  const unsigned disk = static_cast<unsigned>(std::countr_zero(k)) + 1;
+  const int to = peg_after(n, disk, k);
+  return {disk, (to + 3 - hanoi_dir(n, disk)) % 3, to};
+}
+
+// Peg of every disk (index d - 1) after the first k moves, in O(n).
+std::vector<std::uint8_t> pegs_after(unsigned n, u64 k) {
+  check_hanoi(n, k);
+  std::vector<std::uint8_t> pegs(n);
+  for (unsigned d = 1; d <= n; ++d) pegs[d - 1] = static_cast<std::uint8_t>(peg_after(n, d, k));
+  return pegs;
+}
+
+inline constexpr u64 hanoi_block = 1 << 20;
+
+// Formats moves [lo, hi) in the same text as hanoi_iter_gray, starting from the pegs after lo - 1.
+void format_moves(unsigned n, u64 lo, u64 hi, std::array<char, 3> names, std::string& out) {
+  std::vector<std::uint8_t> pos = pegs_after(n, lo - 1);
+  const int dir_odd = (n % 2 == 0) ? 1 : 2;
+  const int dir_even = 3 - dir_odd;
+  char line[48] = "move disk ";
+  for (u64 m = lo; m < hi; ++m) {
+    const int k = std::countr_zero(m) + 1;
+    const int dir = (k & 1) ? dir_odd : dir_even;
+    const int from = pos[k - 1];
+    const int to = (from + dir) % 3;
+    char* p = std::to_chars(line + 10, line + sizeof line, k).ptr;
+    *p++ = ':'; *p++ = ' '; *p++ = names[from];
+    *p++ = ' '; *p++ = '-'; *p++ = '>'; *p++ = ' '; *p++ = names[to]; *p++ = '\n';
+    out.append(line, p);
+    pos[k - 1] = static_cast<std::uint8_t>(to);
+  }
+}
+
+// Writes the full solution like hanoi_iter_gray, but each round formats one block of moves per
+// thread into its own buffer, then the buffers go out in order with one fwrite each.
+void write_moves(unsigned n, std::FILE* out, std::array<char, 3> names = {'A','B','C'}, unsigned threads = 0) {
+  if (n == 0) return;
+  check_hanoi(n, 0);
+  const u64 total = (1ULL << n) - 1;
+  std::fprintf(out, "total moves = %llu\n", total);
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<std::string> bufs(threads);
+  for (u64 next = 1; next <= total; ) {
+    std::vector<std::pair<u64, u64>> parts;
+    for (unsigned t = 0; t < threads && next <= total; ++t) {
+      const u64 hi = std::min(total + 1, next + hanoi_block);
+      parts.emplace_back(next, hi);
+      next = hi;
+    }
+
+    for (auto& b : bufs) b.clear();
+    if (parts.size() == 1) {
+      format_moves(n, parts[0].first, parts[0].second, names, bufs[0]);
+    } else {
+      std::vector<std::jthread> pool;
+      pool.reserve(parts.size());
+      for (std::size_t t = 0; t < parts.size(); ++t)
+        pool.emplace_back([&, t] { format_moves(n, parts[t].first, parts[t].second, names, bufs[t]); });
+    }
+    for (std::size_t t = 0; t < parts.size(); ++t)
+      if (std::fwrite(bufs[t].data(), 1, bufs[t].size(), out) != bufs[t].size()) throw std::runtime_error("write failed");
+  }
+}
+
+// Replays move_at against the rules, compares pegs_after with the replay, and checks that
+// write_moves prints exactly what hanoi_iter_gray prints, across block and thread splits.
+int check() {
+  int failures = 0;
+  auto expect = [&](bool ok, const std::string& what) {
+    if (!ok) {
+      std::cout << "FAIL " << what << '\n';
+      ++failures;
+    }
+  };
+
+  for (unsigned n = 1; n <= 16; ++n) {
+    std::array<std::vector<unsigned>, 3> peg;
+    for (unsigned d = n; d >= 1; --d) peg[0].push_back(d);
+    bool legal = true, tracked = true;
+    for (u64 k = 1; k < 1ULL << n && legal; ++k) {
+      const Move m = move_at(n, k);
+      legal = !peg[m.from].empty() && peg[m.from].back() == m.disk && m.from != m.to &&
+              (peg[m.to].empty() || peg[m.to].back() > m.disk);
+      if (!legal) break;
+      peg[m.from].pop_back();
+      peg[m.to].push_back(m.disk);
+      if (k % 97 == 1 || k + 1 == 1ULL << n) {
+        const auto pegs = pegs_after(n, k);
+        for (int p = 0; p < 3; ++p)
+          for (unsigned d : peg[p]) tracked &= pegs[d - 1] == p;
+      }
+    }
+    expect(legal, "move_at plays legal moves, n = " + std::to_string(n));
+    expect(tracked, "pegs_after matches the replay, n = " + std::to_string(n));
+    expect(legal && peg[2].size() == n, "all disks end on the last peg, n = " + std::to_string(n));
+  }
+
+  bool threw = true;
+  for (auto [n, k] : {std::pair{3u, 0ULL}, {3u, 8ULL}, {64u, 1ULL}}) {
+    try {
+      (void)move_at(n, k);
+      threw = false;
+    } catch (const std::runtime_error&) {
+    }
+  }
+  expect(threw, "move_at rejects k = 0, k >= 2^n and n > 63");
+
+  auto capture = [](auto&& f) {
+    std::FILE* tmp = std::tmpfile();
+    if (!tmp) throw std::runtime_error("tmpfile failed");
+    f(tmp);
+    std::string text(static_cast<std::size_t>(std::ftell(tmp)), '\0');
+    std::rewind(tmp);
+    if (std::fread(text.data(), 1, text.size(), tmp) != text.size()) throw std::runtime_error("read failed");
+    std::fclose(tmp);
+    return text;
+  };
+  // n = 21 needs two blocks of hanoi_block moves, so three threads get an uneven round.
+  for (unsigned n : {1u, 2u, 3u, 10u, 15u, 21u}) {
+    std::ostringstream gray;
+    auto* old = std::cout.rdbuf(gray.rdbuf());
+    hanoi_iter_gray(n);
+    std::cout.rdbuf(old);
+    for (unsigned threads : {1u, 3u}) {
+      const std::string text = capture([&](std::FILE* f) { write_moves(n, f, {'A', 'B', 'C'}, threads); });
+      expect(text == gray.str(), "write_moves matches hanoi_iter_gray, n = " + std::to_string(n) +
+                                     ", threads = " + std::to_string(threads));
+    }
+  }
+
+  std::cout << (failures ? "check failed" : "all checks passed") << '\n';
+  return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
   std::cout.tie(nullptr);
+  if (argc > 1 && std::string_view(argv[1]) == "--check") return check();
 
+  // "n" prints the whole solution; "n k" prints only move k and the pegs after it.
   unsigned n;
   if (!(std::cin >> n)) return 0;
-  hanoi_iter_gray(n, {'A','B','C'});
-  
+  const std::array<char, 3> names = {'A','B','C'};
+  try {
+    if (u64 k; std::cin >> k) {
+      const Move m = move_at(n, k);
+      std::cout << "move disk " << m.disk << ": " << names[m.from] << " -> " << names[m.to] << '\n';
+      std::cout << "pegs:";
+      for (auto p : pegs_after(n, k)) std::cout << ' ' << names[p];
+      std::cout << '\n';
+      return 0;
+    }
+    write_moves(n, stdout, names);
+  } catch (const std::exception& e) {
+    std::cout.flush();
+    std::cerr << "hanoi: " << e.what() << '\n';
+    return 1;
+  }
+
   return 0;
 }
@@ -59,15 +59,625 @@ std::optional <Plan> solve(int cap_a, int cap_b, int target) {
   return path;
 }
 
-int main() {
+// Iterative extended Euclid: returns gcd(a, b) and sets x, y with a*x + b*y = gcd.
+i64 ext_gcd(i64 a, i64 b, i64& x, i64& y) {
+  i64 x1 = 0, y1 = 1;
+  x = 1, y = 0;
+  while (b) {
+    i64 q = a / b;
+    std::tie(a, b) = std::pair{b, a - q * b};
+    std::tie(x, x1) = std::pair{x1, x - q * x1};
+    std::tie(y, y1) = std::pair{y1, y - q * y1};
+  }
+  return a;
+}
+
+// Smallest k >= 1 with k*s = r (mod d), or 0 when there is none.
+u64 min_multiplier(u64 s, u64 d, u64 r) {
+  i64 x, y;
+  const u64 g = static_cast<u64>(ext_gcd(static_cast<i64>(s), static_cast<i64>(d), x, y));
+  if (r % g) return 0;
+  const u64 m = d / g;
+  const u64 inv = static_cast<u64>((x % static_cast<i64>(m) + static_cast<i64>(m)) % static_cast<i64>(m));
+  const u64 k = static_cast<u64>(static_cast<unsigned __int128>(r / g % m) * inv % m);
+  return k ? k : m;
+}
+
+// The canonical cycle that only ever fills src, pours src -> dst and empties dst. Every pour ends
+// when the total moved, w, reaches a multiple of s (src now empty) or of d (dst now full), so
+// the target first shows up at the smallest such w with k*s = t (mod d) or j*d = -t (mod s),
+// and the steps taken by then are the fills, empties and pours below w.
+std::optional<u64> cycle_steps(u64 s, u64 d, u64 t) {
+  if (t == s) return 1;
+  if (s == 0 || d == 0) return std::nullopt;
+
+  u64 w = 0;
+  auto consider = [&](u64 x) { if (!w || x < w) w = x; };
+  if (t == d) consider(d);
+  if (t < d)
+    if (u64 k = min_multiplier(s, d, t)) consider(k * s);
+  if (t < s)
+    if (u64 j = min_multiplier(d, s, s - t)) consider(j * d);
+  if (!w) return std::nullopt;
+
+  const u64 l = s / std::gcd(s, d) * d;
+  const u64 fills = (w + s - 1) / s, empties = (w + d - 1) / d - 1, pours = w / s + w / d - w / l;
+  return fills + empties + pours;
+}
+
+// Lazily replays a cycle for a known number of steps; holds O(1) state.
+class JugPlan {
+public:
+  class iterator {
+    int cap_src_ = 0, cap_dst_ = 0, src_ = 0, dst_ = 0;
+    bool a_to_b_ = true;
+    u64 left_ = 0;
+    Step cur_{};
+
+    void advance() {
+      std::string_view op;
+      if (src_ == 0) {
+        src_ = cap_src_;
+        op = a_to_b_ ? "fill A" : "fill B";
+      } else if (dst_ == cap_dst_) {
+        dst_ = 0;
+        op = a_to_b_ ? "empty B" : "empty A";
+      } else {
+        int pour = std::min(src_, cap_dst_ - dst_);
+        src_ -= pour, dst_ += pour;
+        op = a_to_b_ ? "pour A->B" : "pour B->A";
+      }
+      cur_ = {op, a_to_b_ ? State{src_, dst_} : State{dst_, src_}};
+    }
+
+  public:
+    using value_type = Step;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    iterator(int cap_src, int cap_dst, bool a_to_b, u64 steps)
+      : cap_src_(cap_src), cap_dst_(cap_dst), a_to_b_(a_to_b), left_(steps) {
+      if (left_) advance();
+    }
+
+    const Step& operator*() const { return cur_; }
+    iterator& operator++() {
+      if (--left_) advance();
+      return *this;
+    }
+    iterator operator++(int) { auto t = *this; ++*this; return t; }
+    bool operator==(std::default_sentinel_t) const { return left_ == 0; }
+  };
+
+  JugPlan(int cap_a, int cap_b, bool a_to_b, u64 steps)
+    : cap_a_(cap_a), cap_b_(cap_b), a_to_b_(a_to_b), steps_(steps) {}
+
+  u64 size() const { return steps_; }
+  iterator begin() const {
+    return a_to_b_ ? iterator(cap_a_, cap_b_, true, steps_) : iterator(cap_b_, cap_a_, false, steps_);
+  }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  int cap_a_, cap_b_;
+  bool a_to_b_;
+  u64 steps_;
+};
+
+// Same optimum as solve(), without the (cap_a+1)*(cap_b+1) state space: the shorter of the
+// A->B and B->A cycles, whose lengths come from extended gcd.
+std::optional<JugPlan> solve_gcd(int cap_a, int cap_b, int target) {
+  if (cap_a < 0 || cap_b < 0 || target < 0) return std::nullopt;
+  if (target == 0) return JugPlan(cap_a, cap_b, true, 0);
+  if (target > std::max(cap_a, cap_b)) return std::nullopt;
+
+  auto ab = cycle_steps(cap_a, cap_b, target), ba = cycle_steps(cap_b, cap_a, target);
+  if (!ab && !ba) return std::nullopt;
+  if (ab && (!ba || *ab <= *ba)) return JugPlan(cap_a, cap_b, true, *ab);
+  return JugPlan(cap_a, cap_b, false, *ba);
+}
+
+// Exhaustive cross-check of solve_gcd against the BFS for every capacity up to n.
+bool check_against_bfs(int n) {
+  for (int a = 0; a <= n; ++a)
+    for (int b = 0; b <= n; ++b)
+      for (int t = 0; t <= std::max(a, b) + 1; ++t) {
+        auto bfs = solve(a, b, t);
+        auto fast = solve_gcd(a, b, t);
+        if (bfs.has_value() != fast.has_value() || (bfs && bfs->size() != fast->size())) {
+          std::cout << "mismatch at " << a << ' ' << b << ' ' << t << '\n';
+          return false;
+        }
+        if (!fast) continue;
+        State last{0, 0};
+        for (const Step& s : *fast) last = s.after;
+        if (t && last.a != t && last.b != t) {
+          std::cout << "plan misses target at " << a << ' ' << b << ' ' << t << '\n';
+          return false;
+        }
+      }
+  return true;
+}
+
+// ---- N jugs -------------------------------------------------------------------------------
+
+struct JugGoal {
+  enum class Kind { AnyJug, Jug, Total };
+  Kind kind = Kind::AnyJug;
+  int amount = 0;
+  int jug = 0;  // only for Kind::Jug
+};
+
+struct SearchStats {
+  u64 expanded = 0;          // states whose moves were generated
+  u64 generated = 0;         // successor / predecessor states produced
+  std::size_t seeds = 0;     // goal states the backward search started from
+  std::size_t bytes = 0;     // peak size of hash tables and frontiers
+  bool bidirectional = false;
+};
+
+struct NStep {
+  std::string op;
+  std::vector<int> after;
+};
+
+// Mixed-radix packing of jug contents: jug i has weight (cap_0+1)...(cap_{i-1}+1).
+class JugCodec {
+  std::vector<int> cap_;
+  std::vector<u64> radix_;
+
+public:
+  explicit JugCodec(std::span<const int> caps) : cap_(caps.begin(), caps.end()), radix_(caps.size()) {
+    unsigned __int128 r = 1;
+    for (std::size_t i = 0; i < caps.size(); ++i) {
+      if (caps[i] < 0) throw std::runtime_error("negative capacity");
+      radix_[i] = static_cast<u64>(r);
+      r *= static_cast<unsigned>(caps[i]) + 1;
+      if (r >= std::numeric_limits<u64>::max()) throw std::runtime_error("state space does not fit in 64 bits");
+    }
+  }
+
+  std::size_t size() const { return cap_.size(); }
+  int cap(std::size_t i) const { return cap_[i]; }
+  int get(u64 key, std::size_t i) const { return static_cast<int>(key / radix_[i] % (cap_[i] + 1)); }
+  u64 add(u64 key, std::size_t i, int delta) const { return key + static_cast<u64>(static_cast<i64>(delta)) * radix_[i]; }
+
+  std::vector<int> decode(u64 key) const {
+    std::vector<int> x(cap_.size());
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = get(key, i);
+    return x;
+  }
+};
+
+// Flat open-addressing map from packed state to its BFS parent; linear probing, load <= 1/2.
+class StateTable {
+public:
+  struct Entry {
+    u64 key;
+    u64 parent;
+    std::uint32_t dist;
+    std::uint16_t op;
+  };
+  static constexpr u64 empty_key = ~0ULL;
+
+private:
+  std::vector<Entry> slots_;
+  std::size_t size_ = 0;
+
+  static u64 mix(u64 x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  std::size_t probe(u64 key) const {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t i = mix(key) & mask;
+    while (slots_[i].key != key && slots_[i].key != empty_key) i = (i + 1) & mask;
+    return i;
+  }
+
+  void grow() {
+    std::vector<Entry> old(std::max<std::size_t>(16, slots_.size() * 2), Entry{empty_key, 0, 0, 0});
+    old.swap(slots_);
+    for (const Entry& e : old)
+      if (e.key != empty_key) slots_[probe(e.key)] = e;
+  }
+
+public:
+  StateTable() { grow(); }
+
+  const Entry* find(u64 key) const {
+    const Entry& e = slots_[probe(key)];
+    return e.key == key ? &e : nullptr;
+  }
+
+  // False if the key was already present.
+  bool insert(const Entry& e) {
+    if (2 * (size_ + 1) > slots_.size()) grow();
+    Entry& slot = slots_[probe(e.key)];
+    if (slot.key == e.key) return false;
+    slot = e;
+    ++size_;
+    return true;
+  }
+
+  std::size_t size() const { return size_; }
+  std::size_t bytes() const { return slots_.size() * sizeof(Entry); }
+};
+
+inline constexpr std::size_t max_goal_seeds = 1 << 20;
+
+// op = kind * 64 + from * 8 + to, kind 0 = fill, 1 = empty, 2 = pour.
+inline std::string jug_op_name(std::uint16_t op) {
+  const char from = static_cast<char>('A' + (op >> 3 & 7)), to = static_cast<char>('A' + (op & 7));
+  if (op >> 6 == 0) return std::string("fill ") + from;
+  if (op >> 6 == 1) return std::string("empty ") + from;
+  return std::string("pour ") + from + "->" + to;
+}
+
+template <class F>
+void for_each_successor(const JugCodec& c, u64 key, F&& f) {
+  const std::size_t n = c.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    const int x = c.get(key, i);
+    if (x < c.cap(i)) f(c.add(key, i, c.cap(i) - x), static_cast<std::uint16_t>(i << 3));
+    if (x > 0) f(c.add(key, i, -x), static_cast<std::uint16_t>(64 | i << 3));
+    if (x == 0) continue;
+    for (std::size_t j = 0; j < n; ++j) {
+      if (j == i) continue;
+      const int p = std::min(x, c.cap(j) - c.get(key, j));
+      if (p > 0) f(c.add(c.add(key, i, -p), j, p), static_cast<std::uint16_t>(128 | i << 3 | j));
+    }
+  }
+}
+
+// Every state s' with a move s' -> key, reported with that move.
+template <class F>
+void for_each_predecessor(const JugCodec& c, u64 key, F&& f) {
+  const std::size_t n = c.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    const int x = c.get(key, i), cap = c.cap(i);
+    if (x == cap)
+      for (int v = 0; v < cap; ++v) f(c.add(key, i, v - x), static_cast<std::uint16_t>(i << 3));
+    if (x == 0)
+      for (int v = 1; v <= cap; ++v) f(c.add(key, i, v), static_cast<std::uint16_t>(64 | i << 3));
+    for (std::size_t j = 0; j < n; ++j) {
+      if (j == i) continue;
+      const int y = c.get(key, j), op = 128 | static_cast<int>(i << 3 | j);
+      // Source poured out completely...
+      if (x == 0)
+        for (int p = 1; p <= std::min(y, cap); ++p) f(c.add(c.add(key, i, p), j, -p), static_cast<std::uint16_t>(op));
+      // ...or destination filled to the brim (skip the amounts the first case already produced).
+      if (y == c.cap(j))
+        for (int p = x == 0 ? y + 1 : 1; p <= std::min(c.cap(j), cap - x); ++p)
+          f(c.add(c.add(key, i, p), j, -p), static_cast<std::uint16_t>(op));
+    }
+  }
+}
+
+// Goal states that some move can produce (a move always leaves a jug empty or full), or
+// nullopt once there are more than `limit` of them or the enumeration itself gets too long.
+std::optional<std::vector<u64>> goal_states(const JugCodec& c, const JugGoal& goal, std::size_t limit) {
+  const std::size_t n = c.size();
+  std::vector<u64> out;
+  std::vector<int> x(n);
+  std::vector<long long> suffix_cap(n + 1, 0);
+  for (std::size_t i = n; i-- > 0;) suffix_cap[i] = suffix_cap[i + 1] + c.cap(i);
+  std::size_t budget = 16 * limit;
+
+  auto on_edge = [&] {
+    for (std::size_t i = 0; i < n; ++i) if (x[i] == 0 || x[i] == c.cap(i)) return true;
+    return false;
+  };
+
+  // Depth-first over jug contents with jug `fixed` pinned to the amount; for totals the
+  // remaining capacity bounds each jug instead.
+  auto rec = [&](auto&& self, std::size_t i, std::size_t fixed, long long sum) -> bool {
+    if (i == n) {
+      if (budget-- == 0) return false;
+      if (!on_edge()) return true;
+      u64 key = 0;
+      for (std::size_t k = 0; k < n; ++k) key = c.add(key, k, x[k]);
+      out.push_back(key);
+      return out.size() <= limit;
+    }
+    int lo = 0, hi = c.cap(i);
+    if (i == fixed) lo = hi = goal.amount;
+    if (goal.kind == JugGoal::Kind::Total) {
+      lo = static_cast<int>(std::max<long long>(0, goal.amount - sum - suffix_cap[i + 1]));
+      hi = static_cast<int>(std::min<long long>(hi, goal.amount - sum));
+    }
+    for (int v = lo; v <= hi; ++v) {
+      x[i] = v;
+      if (!self(self, i + 1, fixed, sum + v)) return false;
+    }
+    return true;
+  };
+
+  bool ok = true;
+  if (goal.kind == JugGoal::Kind::Total) ok = rec(rec, 0, n, 0);
+  else if (goal.kind == JugGoal::Kind::Jug) ok = goal.amount > c.cap(goal.jug) || rec(rec, 0, goal.jug, 0);
+  else
+    for (std::size_t i = 0; i < n && ok; ++i) ok = goal.amount > c.cap(i) || rec(rec, 0, i, 0);
+  if (!ok) return std::nullopt;
+  std::ranges::sort(out);
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  return out;
+}
+
+// Shortest plan for N jugs (all initially empty) to reach the goal. Bidirectional BFS between
+// the start and every goal state, expanding whichever frontier is smaller one level at a time;
+// falls back to a forward-only search when the goal set is too large to seed.
+std::optional<std::vector<NStep>> solve_n(std::span<const int> caps, const JugGoal& goal,
+                                          SearchStats* stats = nullptr) {
+  if (caps.empty() || caps.size() > 8) throw std::runtime_error("between 1 and 8 jugs");
+  if (goal.kind == JugGoal::Kind::Jug && (goal.jug < 0 || static_cast<std::size_t>(goal.jug) >= caps.size()))
+    throw std::runtime_error("no such jug");
+  const JugCodec codec(caps);
+  SearchStats st;
+  if (goal.amount < 0) {
+    if (stats) *stats = st;
+    return std::nullopt;
+  }
+
+  auto is_goal = [&](u64 key) {
+    if (goal.kind == JugGoal::Kind::Jug) return codec.get(key, goal.jug) == goal.amount;
+    long long sum = 0;
+    for (std::size_t i = 0; i < codec.size(); ++i) {
+      const int x = codec.get(key, i);
+      if (goal.kind == JugGoal::Kind::AnyJug && x == goal.amount) return true;
+      sum += x;
+    }
+    return goal.kind == JugGoal::Kind::Total && sum == goal.amount;
+  };
+
+  auto finish = [&](auto&& result) {
+    if (stats) *stats = st;
+    return result;
+  };
+  if (is_goal(0)) return finish(std::optional<std::vector<NStep>>(std::vector<NStep>{}));
+
+  StateTable fwd, bwd;
+  std::vector<u64> ffront{0}, bfront, next;
+  fwd.insert({0, 0, 0, 0});
+
+  auto seeds = goal_states(codec, goal, max_goal_seeds);
+  st.bidirectional = seeds.has_value();
+  if (seeds) {
+    for (u64 g : *seeds)
+      if (bwd.insert({g, g, 0, 0})) bfront.push_back(g);
+    st.seeds = bfront.size();
+    if (bfront.empty()) return finish(std::optional<std::vector<NStep>>{});
+  }
+
+  // Best meeting point: forward node, move, backward node.
+  struct Meet { u64 f, b; std::uint16_t op; std::uint32_t len; };
+  std::optional<Meet> meet;
+  auto track_bytes = [&] {
+    st.bytes = std::max(st.bytes, fwd.bytes() + bwd.bytes() +
+                                  (ffront.capacity() + bfront.capacity() + next.capacity()) * sizeof(u64));
+  };
+
+  while (!meet && !ffront.empty() && (!st.bidirectional || !bfront.empty())) {
+    next.clear();
+    if (!st.bidirectional || ffront.size() <= bfront.size()) {
+      for (u64 u : ffront) {
+        ++st.expanded;
+        const std::uint32_t d = fwd.find(u)->dist + 1;
+        for_each_successor(codec, u, [&](u64 v, std::uint16_t op) {
+          ++st.generated;
+          if (st.bidirectional) {
+            if (const auto* e = bwd.find(v); e && (!meet || d + e->dist < meet->len)) meet = Meet{u, v, op, d + e->dist};
+          } else if (!meet && is_goal(v)) {
+            fwd.insert({v, u, d, op});
+            meet = Meet{v, v, 0, d};
+          }
+          if (fwd.insert({v, u, d, op})) next.push_back(v);
+        });
+      }
+      ffront.swap(next);
+    } else {
+      for (u64 u : bfront) {
+        ++st.expanded;
+        const std::uint32_t d = bwd.find(u)->dist + 1;
+        for_each_predecessor(codec, u, [&](u64 v, std::uint16_t op) {
+          ++st.generated;
+          if (const auto* e = fwd.find(v); e && (!meet || d + e->dist < meet->len)) meet = Meet{v, u, op, d + e->dist};
+          if (bwd.insert({v, u, d, op})) next.push_back(v);
+        });
+      }
+      bfront.swap(next);
+    }
+    track_bytes();
+  }
+  if (!meet) return finish(std::optional<std::vector<NStep>>{});
+
+  std::vector<NStep> plan;
+  for (u64 k = meet->f; k != 0;) {
+    const auto* e = fwd.find(k);
+    plan.push_back({jug_op_name(e->op), codec.decode(k)});
+    k = e->parent;
+  }
+  std::reverse(plan.begin(), plan.end());
+  if (st.bidirectional) {
+    plan.push_back({jug_op_name(meet->op), codec.decode(meet->b)});
+    for (u64 k = meet->b;;) {
+      const auto* e = bwd.find(k);
+      if (e->parent == k) break;
+      plan.push_back({jug_op_name(e->op), codec.decode(e->parent)});
+      k = e->parent;
+    }
+  }
+  return finish(std::optional<std::vector<NStep>>(std::move(plan)));
+}
+
+inline bool jug_goal_met(const std::vector<int>& x, const JugGoal& goal) {
+  if (goal.kind == JugGoal::Kind::Jug) return x[goal.jug] == goal.amount;
+  if (goal.kind == JugGoal::Kind::AnyJug) return std::ranges::count(x, goal.amount) > 0;
+  return std::accumulate(x.begin(), x.end(), 0) == goal.amount;
+}
+
+// Plain forward BFS over unpacked states: the length of a shortest plan, or -1.
+int jug_bfs_steps(const std::vector<int>& caps, const JugGoal& goal) {
+  std::map<std::vector<int>, int> dist{{std::vector<int>(caps.size()), 0}};
+  std::queue<std::vector<int>> q;
+  q.push(std::vector<int>(caps.size()));
+  while (!q.empty()) {
+    const std::vector<int> x = q.front();
+    q.pop();
+    const int d = dist[x];
+    if (jug_goal_met(x, goal)) return d;
+    auto visit = [&](std::vector<int> y) {
+      if (dist.emplace(y, d + 1).second) q.push(std::move(y));
+    };
+    for (std::size_t i = 0; i < caps.size(); ++i) {
+      auto y = x;
+      y[i] = caps[i];
+      visit(y);
+      y[i] = 0;
+      visit(y);
+      for (std::size_t j = 0; j < caps.size(); ++j) {
+        if (j == i) continue;
+        y = x;
+        const int p = std::min(x[i], caps[j] - x[j]);
+        y[i] -= p;
+        y[j] += p;
+        visit(y);
+      }
+    }
+  }
+  return -1;
+}
+
+// solve_n against jug_bfs_steps on every 2-jug instance with capacities up to 7 and every 3-jug
+// instance up to 4, for every goal; each plan is replayed move by move.
+bool check_solve_n() {
+  auto check_one = [](const std::vector<int>& caps, const JugGoal& goal) {
+    const auto plan = solve_n(caps, goal);
+    const int want = jug_bfs_steps(caps, goal);
+    if (plan.has_value() != (want >= 0) || (plan && static_cast<int>(plan->size()) != want)) return false;
+    if (!plan) return true;
+    std::vector<int> x(caps.size());
+    for (const NStep& s : *plan) {
+      const std::size_t i = s.op[s.op.find(' ') + 1] - 'A', j = s.op.back() - 'A';
+      if (s.op.starts_with("fill ")) x[i] = caps[i];
+      else if (s.op.starts_with("empty ")) x[i] = 0;
+      else {
+        const int p = std::min(x[i], caps[j] - x[j]);
+        x[i] -= p;
+        x[j] += p;
+      }
+      if (x != s.after) return false;
+    }
+    return jug_goal_met(x, goal);
+  };
+
+  for (std::size_t n : {2u, 3u}) {
+    const int max_cap = n == 2 ? 7 : 4;
+    std::vector<int> caps(n, 0);
+    for (;;) {
+      const int total = std::accumulate(caps.begin(), caps.end(), 0);
+      std::vector<JugGoal> goals;
+      for (int t = -1; t <= max_cap + 1; ++t) {
+        goals.push_back({JugGoal::Kind::AnyJug, t, 0});
+        for (std::size_t j = 0; j < n; ++j) goals.push_back({JugGoal::Kind::Jug, t, static_cast<int>(j)});
+      }
+      for (int t = -1; t <= total + 1; ++t) goals.push_back({JugGoal::Kind::Total, t, 0});
+      for (const JugGoal& g : goals)
+        if (!check_one(caps, g)) {
+          std::cout << "solve_n mismatch at caps";
+          for (int c : caps) std::cout << ' ' << c;
+          std::cout << ", goal kind " << static_cast<int>(g.kind) << " amount " << g.amount << " jug " << g.jug << '\n';
+          return false;
+        }
+      std::size_t i = 0;
+      while (i < n && caps[i] == max_cap) caps[i++] = 0;
+      if (i == n) break;
+      ++caps[i];
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
   std::cout.tie(nullptr);
 
+  // --check N: solve_gcd against the BFS for capacities up to N, then solve_n on small instances.
+  if (argc > 1 && std::string_view(argv[1]) == "--check") {
+    int n = -1;
+    if (argc > 2) std::from_chars(argv[2], argv[2] + std::strlen(argv[2]), n);
+    if (n < 0) {
+      std::cerr << "usage: water --check N\n";
+      return 2;
+    }
+    const bool ok = check_against_bfs(n) && check_solve_n();
+    std::cout << (ok ? "ok" : "FAILED") << '\n';
+    return ok ? 0 : 1;
+  }
+
+  // --jugs reads "n cap_1 .. cap_n" and a goal: "any T", "jug <letter> T" or "total T".
+  if (argc > 1 && std::string_view(argv[1]) == "--jugs") {
+    auto usage = [](const std::string& why) {
+      std::cerr << "water: " << why << "\n"
+                << "usage: water --jugs, reading \"n cap_1 .. cap_n\" (1 <= n <= 8, capacities >= 0)\n"
+                << "       then \"any T\", \"jug <letter> T\" or \"total T\"\n";
+      return 2;
+    };
+    std::size_t n;
+    if (!(std::cin >> n)) return 0;
+    if (n < 1 || n > 8) return usage("between 1 and 8 jugs");
+    std::vector<int> caps(n);
+    for (int& c : caps) {
+      if (!(std::cin >> c)) return usage("expected " + std::to_string(n) + " capacities");
+      if (c < 0) return usage("negative capacity " + std::to_string(c));
+    }
+    std::string kind;
+    JugGoal goal;
+    if (!(std::cin >> kind)) return usage("missing goal");
+    if (kind == "jug") {
+      char j;
+      if (!(std::cin >> j) || j < 'A' || j >= static_cast<char>('A' + n))
+        return usage(std::string("jug must be a letter from A to ") + static_cast<char>('A' + n - 1));
+      goal.kind = JugGoal::Kind::Jug;
+      goal.jug = j - 'A';
+    } else if (kind == "total" || kind == "any") {
+      goal.kind = kind == "total" ? JugGoal::Kind::Total : JugGoal::Kind::AnyJug;
+    } else {
+      return usage("unknown goal \"" + kind + "\"");
+    }
+    if (!(std::cin >> goal.amount)) return usage("missing goal amount");
+
+    SearchStats st;
+    std::optional<std::vector<NStep>> plan;
+    try {
+      plan = solve_n(caps, goal, &st);
+    } catch (const std::exception& e) {
+      std::cerr << "water: " << e.what() << '\n';
+      return 1;
+    }
+    if (plan) {
+      std::cout << "steps = " << plan->size() << '\n';
+      int i = 0;
+      for (const auto& s : *plan) {
+        std::cout << ++i << ". " << s.op << " -> (";
+        for (std::size_t k = 0; k < s.after.size(); ++k) std::cout << (k ? "," : "") << s.after[k];
+        std::cout << ")\n";
+      }
+    } else {
+      std::cout << "impossible\n";
+    }
+    std::cout << "expanded = " << st.expanded << ", generated = " << st.generated << ", seeds = " << st.seeds
+              << ", peak bytes = " << st.bytes << (st.bidirectional ? ", bidirectional" : ", forward only") << '\n';
+    return 0;
+  }
+
   int a, b, t;
   if (!(std::cin >> a >> b >> t)) return 0;
 
-  if (auto plan = solve(a, b, t)) {
+  if (auto plan = solve_gcd(a, b, t)) {
     std::cout << "steps = " << plan->size() << '\n';
     int i = 0;
     for (const auto& s : *plan)
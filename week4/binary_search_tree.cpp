@@ -1,120 +1,438 @@
 #include <bits/stdc++.h>
 
+// Immutable sorted set in Eytzinger (BFS) order: a[1] is the root and a[k] has children
+// a[2k], a[2k+1]. The search is branch-free and prefetches the cache line holding the
+// node's descendants a few levels down.
+template <class T, class Comp = std::less<T>>
+class StaticSearchTree {
+public:
+  static constexpr std::size_t line = 64;
+  // a[k * stride] is k's first descendant log2(stride) levels down; stride of them fill a line.
+  static constexpr std::size_t stride = std::bit_floor(std::max<std::size_t>(1, line / sizeof(T)));
+  static constexpr std::size_t batch = 16;
+
+  StaticSearchTree() = default;
+  StaticSearchTree(const StaticSearchTree&) = delete;
+  StaticSearchTree& operator=(const StaticSearchTree&) = delete;
+  StaticSearchTree(StaticSearchTree&& o) noexcept
+      : a_(std::exchange(o.a_, nullptr)), n_(std::exchange(o.n_, 0)), comp_(std::move(o.comp_)) {}
+  StaticSearchTree& operator=(StaticSearchTree&& o) noexcept {
+    if (this != &o) {
+      reset();
+      a_ = std::exchange(o.a_, nullptr);
+      n_ = std::exchange(o.n_, 0);
+      comp_ = std::move(o.comp_);
+    }
+    return *this;
+  }
+  ~StaticSearchTree() { reset(); }
+
+  // `sorted` must be strictly increasing under comp.
+  StaticSearchTree(std::span<const T> sorted, Comp comp) : comp_(std::move(comp)) {
+    if (sorted.empty()) return;
+    for (std::size_t i = 1; i < sorted.size(); ++i)
+      if (!comp_(sorted[i - 1], sorted[i])) throw std::runtime_error("StaticSearchTree: input is not strictly sorted");
+    const std::size_t n = sorted.size();
+    T* a = static_cast<T*>(::operator new((n + 1) * sizeof(T), std::align_val_t{line}));
+    std::size_t i = 0;
+    try {
+      for_each_inorder(n, [&](std::size_t k) { std::construct_at(a + k, sorted[i]); ++i; });
+    } catch (...) {
+      const std::size_t built = std::exchange(i, 0);
+      for_each_inorder(n, [&](std::size_t k) { if (i++ < built) std::destroy_at(a + k); });
+      ::operator delete(a, std::align_val_t{line});
+      throw;
+    }
+    a_ = a;
+    n_ = n;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return n_; }
+  [[nodiscard]] bool empty() const noexcept { return n_ == 0; }
+
+  [[nodiscard]] bool contains(const T& x) const {
+    std::size_t k = 1;
+    while (k <= n_) {
+      prefetch(k);
+      k = 2 * k + comp_(a_[k], x);
+    }
+    return found(k, x);
+  }
+
+  // Runs `batch` searches in lockstep so their cache misses overlap.
+  void contains_many(std::span<const T> xs, std::span<bool> out) const {
+    if (xs.size() != out.size()) throw std::runtime_error("contains_many: size mismatch");
+    const int levels = std::bit_width(n_);
+    std::array<std::size_t, batch> k;
+    for (std::size_t base = 0; base < xs.size(); base += batch) {
+      const std::size_t m = std::min(batch, xs.size() - base);
+      k.fill(1);
+      for (int l = 0; l < levels; ++l)
+        for (std::size_t j = 0; j < m; ++j) {
+          const std::size_t kj = k[j];
+          if (kj > n_) continue;
+          prefetch(kj);
+          k[j] = 2 * kj + comp_(a_[kj], xs[base + j]);
+        }
+      for (std::size_t j = 0; j < m; ++j) out[base + j] = found(k[j], xs[base + j]);
+    }
+  }
+
+private:
+  T* a_ = nullptr;  // a_[1..n_]; slot 0 is never constructed
+  std::size_t n_ = 0;
+  Comp comp_{};
+
+  // k * stride usually lies past the end, so the address is formed as an integer; a prefetch
+  // of an unmapped address does not fault.
+  void prefetch(std::size_t k) const noexcept {
+    __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(a_) + k * stride * sizeof(T)));
+  }
+
+  // The search ends below a leaf after turning right at every node that is less than x;
+  // dropping those trailing right turns plus one left turn recovers the lower bound.
+  bool found(std::size_t k, const T& x) const {
+    k >>= std::countr_one(k) + 1;
+    return k != 0 && !comp_(x, a_[k]);
+  }
+
+  // Visits slots 1..n in the in-order of the implicit tree, i.e. in sorted-key order.
+  template <class F>
+  static void for_each_inorder(std::size_t n, F f) {
+    std::size_t k = 1;
+    while (2 * k <= n) k *= 2;
+    for (std::size_t i = 0; i < n; ++i) {
+      f(k);
+      if (2 * k + 1 <= n) {
+        for (k = 2 * k + 1; 2 * k <= n;) k *= 2;
+      } else {
+        k >>= std::countr_one(k) + 1;
+      }
+    }
+  }
+
+  void reset() noexcept {
+    if (!a_) return;
+    for (std::size_t k = 1; k <= n_; ++k) std::destroy_at(a_ + k);
+    ::operator delete(a_, std::align_val_t{line});
+    a_ = nullptr;
+    n_ = 0;
+  }
+};
+
 template <class T, class Comp = std::less<T>>
 class BinaryTree {
 private:
+  // Children are raw pointers so that from_sorted() can place every node in one block;
+  // the tree owns all nodes and frees them in clear().
   struct Node {
     T value;
-    std::unique_ptr<Node> left, right;
+    Node* left = nullptr;
+    Node* right = nullptr;
     explicit Node(const T& v) : value(v) {}
     explicit Node(T&& v) : value(std::move(v)) {}
     ~Node() = default;
   };
+  using NodeAlloc = std::allocator<Node>;
 
-  std::unique_ptr<Node> root_;
+  Node* root_ = nullptr;
   std::size_t size_ = 0;
   Comp comp_{};
+  Node* block_ = nullptr;  // nodes [block_, block_ + block_size_) come from from_sorted()
+  std::size_t block_size_ = 0;
 
 public:
   BinaryTree() = default;
-  ~BinaryTree() = default;
+  explicit BinaryTree(Comp comp) : comp_(std::move(comp)) {}
+  BinaryTree(const BinaryTree&) = delete;
+  BinaryTree& operator=(const BinaryTree&) = delete;
+  BinaryTree(BinaryTree&& o) noexcept
+      : root_(std::exchange(o.root_, nullptr)), size_(std::exchange(o.size_, 0)), comp_(std::move(o.comp_)),
+        block_(std::exchange(o.block_, nullptr)), block_size_(std::exchange(o.block_size_, 0)) {}
+  BinaryTree& operator=(BinaryTree&& o) noexcept {
+    if (this != &o) {
+      clear();
+      root_ = std::exchange(o.root_, nullptr);
+      size_ = std::exchange(o.size_, 0);
+      comp_ = std::move(o.comp_);
+      block_ = std::exchange(o.block_, nullptr);
+      block_size_ = std::exchange(o.block_size_, 0);
+    }
+    return *this;
+  }
+  ~BinaryTree() { clear(); }
+
+  // Builds a perfectly balanced tree from a range sorted by comp in O(n), with all nodes in a
+  // single allocation. Equivalent neighbours are kept once; unsorted input throws.
+  template <std::ranges::input_range R>
+  [[nodiscard]] static BinaryTree from_sorted(R&& r, Comp comp = Comp{}) {
+    if constexpr (std::ranges::sized_range<R> && std::ranges::forward_range<R>) {
+      return build_sorted(std::ranges::begin(r), static_cast<std::size_t>(std::ranges::size(r)), std::move(comp));
+    } else {
+      std::vector<T> tmp;
+      for (auto&& x : r) tmp.emplace_back(std::forward<decltype(x)>(x));
+      return build_sorted(std::make_move_iterator(tmp.begin()), tmp.size(), std::move(comp));
+    }
+  }
 
   [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
   [[nodiscard]] std::size_t size() const noexcept { return size_; }
 
-  void insert(const T& v) { insert_impl(root_, v); }
-  void insert(T&& v) { insert_impl(root_, std::move(v)); }
+  void insert(const T& v) { insert_impl(v); }
+  void insert(T&& v) { insert_impl(std::move(v)); }
 
   [[nodiscard]] bool contains(const T& x) const {
-    const Node* cur = root_.get();
+    const Node* cur = root_;
     while (cur) {
-      if (comp_(x, cur->value)) cur = cur->left.get();
-      else if (comp_(cur->value, x)) cur = cur->right.get();
+      if (comp_(x, cur->value)) cur = cur->left;
+      else if (comp_(cur->value, x)) cur = cur->right;
       else return true;
     }
     return false;
   }
 
-  [[nodiscard]] int height() const noexcept { return height_impl(root_.get()); }
+  void clear() noexcept {
+    // Rotate left children up so the tree unwinds into its right spine; O(n), no stack.
+    while (Node* n = root_) {
+      if (Node* l = n->left) {
+        n->left = l->right;
+        l->right = n;
+        root_ = l;
+      } else {
+        root_ = n->right;
+        release(n);
+      }
+    }
+    if (block_) NodeAlloc{}.deallocate(block_, block_size_);
+    block_ = nullptr;
+    block_size_ = 0;
+    size_ = 0;
+  }
+
+  // Day-Stout-Warren: flatten into a right vine, then compress it into a tree of minimal
+  // height. O(n) time, O(1) extra space.
+  void rebalance() noexcept {
+    std::size_t n = 0;
+    for (Node** link = &root_; Node* cur = *link;) {
+      if (Node* l = cur->left) {
+        cur->left = l->right;
+        l->right = cur;
+        *link = l;
+      } else {
+        ++n;
+        link = &cur->right;
+      }
+    }
+    const std::size_t leaves = n + 1 - std::bit_floor(n + 1);
+    compress(leaves);
+    for (std::size_t m = n - leaves; m > 1;) {
+      m /= 2;
+      compress(m);
+    }
+  }
+
+  // Read-only snapshot for lookup-heavy use; later changes to this tree do not affect it.
+  [[nodiscard]] StaticSearchTree<T, Comp> freeze() const {
+    const std::vector<T> keys = inorder();
+    return StaticSearchTree<T, Comp>(keys, comp_);
+  }
+
+  [[nodiscard]] int height() const {
+    int h = -1;
+    std::vector<std::pair<const Node*, int>> st;
+    if (root_) st.emplace_back(root_, 0);
+    while (!st.empty()) {
+      auto [n, d] = st.back();
+      st.pop_back();
+      h = std::max(h, d);
+      if (n->left) st.emplace_back(n->left, d + 1);
+      if (n->right) st.emplace_back(n->right, d + 1);
+    }
+    return h;
+  }
 
   [[nodiscard]] std::vector<T> preorder() const {
-    std::vector<T> a; a.reserve(size_); preorder_collect(root_.get(), a); return a;
+    std::vector<T> a; a.reserve(size_); preorder([&](const T& v) { a.push_back(v); }); return a;
   }
   [[nodiscard]] std::vector<T> inorder() const {
-    std::vector<T> a; a.reserve(size_); inorder_collect(root_.get(), a); return a;
+    std::vector<T> a; a.reserve(size_); inorder([&](const T& v) { a.push_back(v); }); return a;
   }
   [[nodiscard]] std::vector<T> postorder() const {
-    std::vector<T> a; a.reserve(size_); postorder_collect(root_.get(), a); return a;
+    std::vector<T> a; a.reserve(size_); postorder([&](const T& v) { a.push_back(v); }); return a;
   }
 
   template <class F>
-  void preorder(F f) const { preorder_visit(root_.get(), f); }
+  void preorder(F f) const {
+    std::vector<const Node*> st;
+    if (root_) st.push_back(root_);
+    while (!st.empty()) {
+      const Node* n = st.back();
+      st.pop_back();
+      f(n->value);
+      if (n->right) st.push_back(n->right);
+      if (n->left) st.push_back(n->left);
+    }
+  }
   template <class F>
-  void inorder(F f) const { inorder_visit(root_.get(), f); }
+  void inorder(F f) const {
+    std::vector<const Node*> st;
+    for (const Node* n = root_; n || !st.empty();) {
+      for (; n; n = n->left) st.push_back(n);
+      n = st.back();
+      st.pop_back();
+      f(n->value);
+      n = n->right;
+    }
+  }
   template <class F>
-  void postorder(F f) const { postorder_visit(root_.get(), f); }
+  void postorder(F f) const {
+    std::vector<const Node*> st;
+    const Node* last = nullptr;
+    for (const Node* n = root_; n || !st.empty();) {
+      for (; n; n = n->left) st.push_back(n);
+      const Node* top = st.back();
+      if (top->right && top->right != last) {
+        n = top->right;
+      } else {
+        f(top->value);
+        last = top;
+        st.pop_back();
+      }
+    }
+  }
 
 private:
   template <class U>
-  void insert_impl(std::unique_ptr<Node>& node, U&& v) {
-    if (!node) { node = std::make_unique<Node>(std::forward<U>(v)); ++size_; return; }
-    if (comp_(v, node->value)) insert_impl(node->left, std::forward<U>(v));
-    else if (comp_(node->value, v)) insert_impl(node->right, std::forward<U>(v));
-    else { }
+  void insert_impl(U&& v) {
+    Node** link = &root_;
+    while (Node* cur = *link) {
+      if (comp_(v, cur->value)) link = &cur->left;
+      else if (comp_(cur->value, v)) link = &cur->right;
+      else return;
+    }
+    *link = new Node(std::forward<U>(v));
+    ++size_;
   }
 
-  static int height_impl(const Node* n) noexcept {
-    if (!n) return -1;
-    return 1 + std::max(height_impl(n->left.get()), height_impl(n->right.get()));
+  template <class It>
+  static BinaryTree build_sorted(It first, std::size_t cap, Comp comp) {
+    BinaryTree t(std::move(comp));
+    if (cap == 0) return t;
+    NodeAlloc alloc;
+    Node* block = alloc.allocate(cap);
+    std::size_t n = 0;
+    try {
+      for (std::size_t i = 0; i < cap; ++i, ++first) {
+        auto&& x = *first;
+        if (n > 0) {
+          if (t.comp_(x, block[n - 1].value)) throw std::runtime_error("from_sorted: input is not sorted");
+          if (!t.comp_(block[n - 1].value, x)) continue;
+        }
+        std::construct_at(block + n, std::forward<decltype(x)>(x));
+        ++n;
+      }
+    } catch (...) {
+      std::destroy_n(block, n);
+      alloc.deallocate(block, cap);
+      throw;
+    }
+    t.block_ = block;
+    t.block_size_ = cap;
+    t.size_ = n;
+    t.root_ = link_balanced(block, n);
+    return t;
   }
 
-  static void preorder_collect(const Node* n, std::vector<T>& a) {
-    if (!n) return;
-    a.push_back(n->value);
-    preorder_collect(n->left.get(), a);
-    preorder_collect(n->right.get(), a);
-  }
-  static void inorder_collect(const Node* n, std::vector<T>& a) {
-    if (!n) return;
-    inorder_collect(n->left.get(), a);
-    a.push_back(n->value);
-    inorder_collect(n->right.get(), a);
-  }
-  static void postorder_collect(const Node* n, std::vector<T>& a) {
-    if (!n) return;
-    postorder_collect(n->left.get(), a);
-    postorder_collect(n->right.get(), a);
-    a.push_back(n->value);
+  bool in_block(const Node* n) const noexcept {
+    std::less<const Node*> lt;
+    return block_ && !lt(n, block_) && lt(n, block_ + block_size_);
   }
 
-  template <class F>
-  static void preorder_visit(const Node* n, F& f) {
-    if (!n) return;
-    f(n->value);
-    preorder_visit(n->left.get(), f);
-    preorder_visit(n->right.get(), f);
+  void release(Node* n) noexcept {
+    if (in_block(n)) std::destroy_at(n);
+    else delete n;
   }
-  template <class F>
-  static void inorder_visit(const Node* n, F& f) {
-    if (!n) return;
-    inorder_visit(n->left.get(), f);
-    f(n->value);
-    inorder_visit(n->right.get(), f);
+
+  // Links nodes [0, n) of an in-order array so that each range's middle element is its root.
+  static Node* link_balanced(Node* nodes, std::size_t n) {
+    struct Range { std::size_t lo, hi; Node** link; };
+    Node* root = nullptr;
+    std::vector<Range> st{{0, n, &root}};
+    while (!st.empty()) {
+      auto [lo, hi, link] = st.back();
+      st.pop_back();
+      if (lo == hi) continue;
+      const std::size_t mid = lo + (hi - lo) / 2;
+      *link = nodes + mid;
+      st.push_back({lo, mid, &nodes[mid].left});
+      st.push_back({mid + 1, hi, &nodes[mid].right});
+    }
+    return root;
   }
-  template <class F>
-  static void postorder_visit(const Node* n, F& f) {
-    if (!n) return;
-    postorder_visit(n->left.get(), f);
-    postorder_visit(n->right.get(), f);
-    f(n->value);
+
+  // One DSW pass: left-rotate every other node down the right spine, `count` times.
+  void compress(std::size_t count) noexcept {
+    Node** link = &root_;
+    for (std::size_t i = 0; i < count; ++i) {
+      Node* child = *link;
+      Node* grand = child->right;
+      child->right = grand->left;
+      grand->left = child;
+      *link = grand;
+      link = &grand->right;
+    }
   }
 };
 
-int main() {
+// Lookup cost for a set of n random keys; half of the queries hit.
+void bench(std::size_t n) {
+  std::mt19937_64 rng(1);
+  std::vector<std::uint32_t> keys(n), queries(n);
+  for (auto& k : keys) k = static_cast<std::uint32_t>(rng()) | 1;
+  for (auto& q : queries) q = rng() & 1 ? keys[rng() % n] : static_cast<std::uint32_t>(rng()) & ~1u;
+
+  BinaryTree<std::uint32_t> tree;
+  for (auto k : keys) tree.insert(k);
+  const std::vector<std::uint32_t> sorted = tree.inorder();
+  const auto frozen = tree.freeze();
+  std::unique_ptr<bool[]> many(new bool[n]);
+
+  auto run = [&](auto&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::size_t hits = f();
+    std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+    return std::pair{dt.count() / static_cast<double>(n), hits};
+  };
+  auto each = [&](auto&& pred) {
+    return [&, pred] { std::size_t h = 0; for (auto q : queries) h += pred(q); return h; };
+  };
+  auto [t_tree, h_tree] = run(each([&](std::uint32_t q) { return tree.contains(q); }));
+  auto [t_lb, h_lb] = run(each([&](std::uint32_t q) { return std::ranges::binary_search(sorted, q); }));
+  auto [t_frozen, h_frozen] = run(each([&](std::uint32_t q) { return frozen.contains(q); }));
+  auto [t_many, h_many] = run([&] {
+    frozen.contains_many(queries, {many.get(), n});
+    return static_cast<std::size_t>(std::count(many.get(), many.get() + n, true));
+  });
+
+  std::cout << std::fixed << std::setprecision(1) << "n = " << n << ", height " << tree.height() << "\n"
+            << "BinaryTree::contains      " << t_tree << " ns\n"
+            << "std::binary_search        " << t_lb << " ns\n"
+            << "StaticSearchTree contains " << t_frozen << " ns\n"
+            << "contains_many             " << t_many << " ns\n"
+            << "hits " << h_tree << ' ' << h_lb << ' ' << h_frozen << ' ' << h_many << '\n';
+}
+
+int main(int argc, char** argv) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
   std::cout.tie(nullptr);
 
+  // --bench [n]: compare lookups in the pointer tree, a sorted vector and the frozen tree.
+  if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+    bench(argc > 2 ? std::stoull(argv[2]) : std::size_t{1} << 22);
+    return 0;
+  }
+
   BinaryTree<int> bt;
   for (int x : {7, 3, 9, 1, 5, 8, 10, 4, 6}) bt.insert(x);
 
@@ -130,6 +448,19 @@ int main() {
   std::cout << "\n";
 
   std::cout << std::boolalpha << "contains 5? " << bt.contains(5) << ", contains 42? " << bt.contains(42) << "\n";
-  
+
+  // Sorted insertion degenerates into a list; rebalance() restores logarithmic height.
+  BinaryTree<int> chain;
+  for (int i = 0; i < 20000; ++i) chain.insert(i);
+  std::cout << "sorted inserts: height=" << chain.height();
+  chain.rebalance();
+  std::cout << ", after rebalance=" << chain.height() << "\n";
+
+  auto big = BinaryTree<int>::from_sorted(std::views::iota(0, 1'000'000));
+  std::cout << "from_sorted: size=" << big.size() << " height=" << big.height() << "\n";
+
+  const auto frozen = bt.freeze();
+  std::cout << "frozen: contains 5? " << frozen.contains(5) << ", contains 42? " << frozen.contains(42) << "\n";
+
   return 0;
 }